@@ -1,8 +1,34 @@
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <conio.h>
+    #include <io.h>
+    #include <direct.h>
+    #define isatty _isatty
+    #ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+        #define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+    #endif
+    #define fileno _fileno
+#else
+    #include <termios.h>
+    #include <unistd.h>
+    #include <pthread.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <sys/mman.h>
+    #include <sys/file.h>
+    #include <fcntl.h>
+    #include <errno.h>
+#endif
 
 #define MAX_BOOKS 500
 #define MAX_MEMBERS 200
@@ -10,10 +36,214 @@
 #define MAX_STRING 100
 #define FINE_PER_DAY 2.0
 #define MAX_BORROW_DAYS 14
+#define SECONDS_PER_DAY (24 * 60 * 60)
+#define FINE_TIER_COUNT 3
+#define ID_HASH_SIZE 1024
+#define RENDER_BUFFER_SIZE (256 * 1024)
+#define RENDER_LINE_MAX 1024
+#define DATE_CACHE_SIZE 256
+#define RENDER_TABLE 0
+#define RENDER_TSV 1
+#define RENDER_CSV 2
+#define RENDER_JSONL 3
+#define ORDER_BY_ID 0
+#define ORDER_BY_TITLE 1
+#define ORDER_BY_AUTHOR 2
+#define ORDER_BY_AVAILABILITY 3
+#define BOOK_ORDER_COUNT 4
+#define ORDER_BY_NAME 1
+#define MEMBER_ORDER_COUNT 2
+#define PAGE_SIZE 50
+#define CURSOR_LENGTH (MAX_STRING + 16)
+#define MAX_PREDICATES 8
+#define SCAN_BATCH 256
+#define FIELD_ID 0
+#define FIELD_TITLE 1
+#define FIELD_AUTHOR 2
+#define FIELD_CATEGORY 3
+#define FIELD_ISBN 4
+#define FIELD_TOTAL 5
+#define FIELD_AVAILABLE 6
+#define FIELD_PRICE 7
+#define OP_EQ 0
+#define OP_NE 1
+#define OP_LT 2
+#define OP_LE 3
+#define OP_GT 4
+#define OP_GE 5
+#define OP_CONTAINS 6
+#define OP_PREFIX 7
+#define BTREE_NODE_BYTES 512
+#define BTREE_ORDER 23
+#define BTREE_MAX_NODES (4 * MAX_BOOKS / BTREE_ORDER + 16)
+#define BTREE_PRICE 0
+#define BTREE_TITLE 1
+#define BTREE_AUTHOR 2
+#define BTREE_COUNT 3
+#define TERM_LENGTH 32
+#define MAX_TERMS 4096
+#define TERM_HASH_SIZE 8192
+#define MAX_POSTINGS 16384
+#define MAX_QUERY_TERMS 8
+#define TERM_TITLE 0
+#define TERM_AUTHOR 1
+#define TERM_MEMBER 2
+#define MAX_TEXT_POSTINGS 8192
+#define MAX_DOC_TERMS 160
+#define TEXT_FIELD_COUNT 3
+#define TERM_STAMP_SIZE 4
+#define FULLTEXT_TOP_K 20
+#define BM25_K1 1.2f
+#define BM25_B 0.75f
+#define SUGGEST_TITLE 0
+#define SUGGEST_AUTHOR 1
+#define SUGGEST_MEMBER 2
+#define SUGGEST_KIND_COUNT 3
+#define SUGGEST_TOP_K 5
+#define MAX_SUGGESTIONS (2 * MAX_BOOKS + MAX_MEMBERS)
+#define SUGGEST_HASH_SIZE 4096
+#define MAX_TRIE_NODES (MAX_SUGGESTIONS * 24)
+#define MAX_BRANCHES 16
+#define BRANCH_NAME_LENGTH 20
+#define BRANCH_ID_SPAN 100000
+#define MAX_BRANCH_LOANS 500
+#define BRANCH_LOCK_SECONDS 5
+#define EVENT_RING_SIZE 4096
+#define EVENT_BATCH 256
+#define EVENT_MAGIC 0x4C455654
+#define EVENT_BOOK_ADDED 0
+#define EVENT_BOOK_UPDATED 1
+#define EVENT_BOOK_DELETED 2
+#define EVENT_MEMBER_ADDED 3
+#define EVENT_MEMBER_UPDATED 4
+#define EVENT_MEMBER_DELETED 5
+#define EVENT_BOOK_ISSUED 6
+#define EVENT_BOOK_RETURNED 7
+#define EVENT_TYPE_COUNT 8
+#define MAX_SNAPSHOT_JOBS 8
+#define MAX_BOOKS_PER_MEMBER 3
+#define MAX_ARCHIVED_BOOKS (2 * MAX_BOOKS)
+#define MAX_ARCHIVED_MEMBERS (2 * MAX_MEMBERS)
+#define COMPACT_MIN_TOMBSTONES 16
+#define MAX_LOAN_DELTAS (2 * MAX_TRANSACTIONS)
+#define LOAN_CHECKPOINT_SPAN 64
+#define MAX_LOAN_CHECKPOINTS (MAX_LOAN_DELTAS / LOAN_CHECKPOINT_SPAN + 1)
+#define LOAN_LIST_HASH_SIZE 4096
+#define MAX_COPIES_PER_BOOK 64
+#define COPY_BARCODE_SPAN 100
+#define SHARED_MAGIC 0x4C534D56
+#define SHARED_BOOKS 0
+#define SHARED_MEMBERS 1
+#define SHARED_TRANSACTIONS 2
+#define SHARED_COPIES 3
+#define SHARED_HOLDS 4
+#define SHARED_ARCHIVE 5
+#define SHARED_ANALYTICS 6
+#define SHARED_CIRCULATION 7
+#define SHARED_REMINDERS 8
+#define SHARED_TABLE_COUNT 9
+#define SHARED_RANGE_SLOTS 4096
+#define SIMULATION_DIR "simulation"
+#define SIMULATION_POPULAR_SKEW 2.0
+#define SIMULATION_HOLD_SHARE 0.5f
+#define SIMULATION_HISTORY_FILE "history.dat"
+#define CHECKSUMS_VERSION 1
+#define CHECKSUM_BLOCK_ROWS 64
+#define CHECKSUM_BLOCKS ((MAX_TRANSACTIONS + CHECKSUM_BLOCK_ROWS - 1) / CHECKSUM_BLOCK_ROWS)
+#define CHECKSUMS_UNRECORDED -1
+#define CHECKED_BOOKS 0
+#define CHECKED_MEMBERS 1
+#define CHECKED_TRANSACTIONS 2
+#define CHECKED_COPIES 3
+#define CHECKED_TABLE_COUNT 4
+#define FSCK_THREADS 4
+#define FSCK_FINE_TOLERANCE 0.005f
+#define COPY_NONE 0
+#define COPY_AVAILABLE 1
+#define COPY_ON_LOAN 2
+#define COPY_RESERVED 3
+#define COPY_DAMAGED 4
+#define COPY_LOST 5
+#define COPY_WITHDRAWN 6
+#define COPIES_VERSION 1
+#define TRANSACTIONS_VERSION 3
+#define MEMBERS_VERSION 2
+#define ARCHIVE_VERSION 2
+#define TIER_STUDENT 0
+#define TIER_FACULTY 1
+#define TIER_STAFF 2
+#define MEMBER_TIER_COUNT 3
+#define MAX_POLICY_CLASSES 16
+#define MAX_LOAN_LIMIT 50
+#define MAX_LOAN_DAYS 365
+#define POLICY_LINE_MAX 256
+#define REMINDERS_VERSION 1
+#define REMINDER_TICK 3600
+#define WHEEL_LEVELS 3
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_DUE (WHEEL_LEVELS * WHEEL_SLOTS)
+#define REMINDER_KINDS 2
+#define REMINDER_DUE_SOON 0
+#define REMINDER_OVERDUE 1
+#define REMINDER_LEAD_DAYS 1
+#define REMINDER_REPEAT_DAYS 7
+#define ISSUE_UNAVAILABLE -1
+#define ISSUE_LIMIT_REACHED -2
+#define ISSUE_LOG_FULL -3
+#define EXPORT_BOOKS 0
+#define EXPORT_MEMBERS 1
+#define EXPORT_TRANSACTIONS 2
+#define EXPORT_LOANS 3
+#define EXPORT_TABLE_COUNT 4
+#define METRIC_TITLES 0
+#define METRIC_MEMBERS 1
+#define METRIC_AUTHORS 2
+#define METRIC_COUNT 3
+#define ANALYTICS_DAYS 365
+#define PANE_SLOTS 16
+#define AUTHOR_SKETCH_SLOTS 128
+#define MERGE_TABLE_SIZE 8192
+#define TOP_N 10
+#define NEIGHBOUR_SLOTS 8
+#define RECENT_BORROWS 8
+#define CO_BORROW_DECAY_LOANS 500
+#define RECOMMEND_SHOWN 3
+#define CIRCULATION_DAYS 4096
+#define MAX_CATEGORIES 16
+#define CATEGORY_LENGTH 32
+#define CIRCULATION_SERIES (MAX_CATEGORIES + 1)
+#define CIRCULATION_BAR_WIDTH 30
+#define PERIOD_DAILY 0
+#define PERIOD_WEEKLY 1
+#define PERIOD_MONTHLY 2
+#define PERIOD_COUNT 3
+#define MAX_HOLDS 1000
+#define HOLD_PICKUP_DAYS 3
+#define HOLD_WAIT_DAYS 60
+#define HOLD_WAITING 0
+#define HOLD_READY 1
+#define HOLD_FULFILLED 2
+#define HOLD_EXPIRED 3
+#define HOLD_CANCELLED 4
 #define BOOKS_FILE "books.dat"
 #define MEMBERS_FILE "members.dat"
 #define TRANSACTIONS_FILE "transactions.dat"
 #define ADMIN_FILE "admin.dat"
+#define ANALYTICS_FILE "analytics.dat"
+#define HOLDS_FILE "holds.dat"
+#define FULLTEXT_FILE "fulltext.dat"
+#define BRANCHES_FILE "branches.dat"
+#define BRANCH_LOANS_FILE "branchloans.dat"
+#define EVENTS_FILE "events.dat"
+#define ARCHIVE_FILE "archive.dat"
+#define CIRCULATION_FILE "circulation.dat"
+#define COPIES_FILE "copies.dat"
+#define SHARED_FILE "shared.dat"
+#define CHECKSUMS_FILE "checksums.dat"
+#define POLICY_FILE "policy.cfg"
+#define REMINDERS_FILE "reminders.dat"
+#define OUTBOX_FILE "outbox.txt"
 
 typedef struct {
     int bookID;
@@ -36,8 +266,20 @@ typedef struct {
     int booksIssued;
     float totalFines;
     int isActive;
+    int tier;
 } Member;
 
+typedef struct {
+    int memberID;
+    char name[MAX_STRING];
+    char email[MAX_STRING];
+    char phone[15];
+    char address[MAX_STRING];
+    int booksIssued;
+    float totalFines;
+    int isActive;
+} MemberV1;
+
 typedef struct {
     int transactionID;
     int bookID;
@@ -47,13 +289,401 @@ typedef struct {
     time_t returnDate;
     float fine;
     int isReturned;
+    int copyBarcode;
+    int tier;
+    int policyClass;
 } Transaction;
 
+typedef struct {
+    int transactionID;
+    int bookID;
+    int memberID;
+    time_t issueDate;
+    time_t dueDate;
+    time_t returnDate;
+    float fine;
+    int isReturned;
+    int copyBarcode;
+} TransactionV2;
+
+typedef struct {
+    int transactionID;
+    int bookID;
+    int memberID;
+    time_t issueDate;
+    time_t dueDate;
+    time_t returnDate;
+    float fine;
+    int isReturned;
+} TransactionV1;
+
+typedef struct {
+    int barcode;
+    int status;
+    int loan;
+} Copy;
+
+typedef struct {
+    int bookID;
+    int count;
+    Copy items[MAX_COPIES_PER_BOOK];
+} CopyRow;
+
+typedef struct {
+    time_t dayStart;
+    time_t dayEnd;
+    char text[12];
+} DateCacheEntry;
+
+typedef struct {
+    int key;
+    int labelID;
+    int count;
+    int error;
+} SketchEntry;
+
+typedef struct {
+    int issues;
+    int returns;
+    int overdue;
+    float fines;
+} DayCounts;
+
+typedef struct {
+    long baseDay;
+    int categoryCount;
+    char categories[MAX_CATEGORIES][CATEGORY_LENGTH];
+    DayCounts days[CIRCULATION_SERIES][CIRCULATION_DAYS];
+} Circulation;
+
+typedef struct {
+    long day;
+    int sizes[METRIC_COUNT];
+    SketchEntry entries[METRIC_COUNT][PANE_SLOTS];
+} AnalyticsPane;
+
+typedef struct {
+    int bookBorrows[MAX_BOOKS];
+    int memberBorrows[MAX_MEMBERS];
+    int authorSize;
+    SketchEntry authorOverdue[AUTHOR_SKETCH_SLOTS];
+    AnalyticsPane panes[ANALYTICS_DAYS];
+    SketchEntry neighbours[MAX_BOOKS][NEIGHBOUR_SLOTS];
+    int neighbourSize[MAX_BOOKS];
+    int recentBorrows[MAX_MEMBERS][RECENT_BORROWS];
+    int coBorrowLoans;
+} Analytics;
+
+typedef struct {
+    int holdID;
+    int bookID;
+    int memberID;
+    time_t placedDate;
+    time_t expiryDate;
+    int status;
+} Hold;
+
+typedef struct {
+    unsigned long long prefix;
+    int bookID;
+    int slot;
+} BTreeKey;
+
+typedef struct {
+    int count;
+    int leaf;
+    int next;
+    BTreeKey keys[BTREE_ORDER + 1];
+    int children[BTREE_ORDER + 2];
+} BTreeNode;
+
+_Static_assert(sizeof(BTreeNode) <= BTREE_NODE_BYTES &&
+               sizeof(BTreeNode) + sizeof(BTreeKey) + sizeof(int) > BTREE_NODE_BYTES,
+               "BTREE_ORDER should fill a BTREE_NODE_BYTES node");
+
+typedef struct {
+    int root;
+    int nodeCount;
+    BTreeNode nodes[BTREE_MAX_NODES];
+} BTree;
+
+typedef struct {
+    int node;
+    int pos;
+} BTreeCursor;
+
+typedef struct {
+    char text[TERM_LENGTH];
+    int child;
+    int sibling;
+    int edge;
+    int postings;
+    int textPostings;
+    int documentFrequency;
+    float maxWeight;
+} Term;
+
+typedef struct {
+    int slot;
+    int kind;
+    int version;
+    int next;
+} Posting;
+
+typedef struct {
+    int slot;
+    int version;
+    unsigned char tf[TEXT_FIELD_COUNT];
+    int next;
+} TextPosting;
+
+typedef struct {
+    int slot;
+    int id;
+    float score;
+} TextMatch;
+
+typedef struct {
+    int kind;
+    int weight;
+    char text[MAX_STRING];
+} Suggestion;
+
+typedef struct {
+    char key;
+    int child;
+    int sibling;
+    int topCount;
+    int top[SUGGEST_TOP_K];
+} TrieNode;
+
+typedef struct {
+    int slot;
+    int id;
+    int contains;
+    int distance;
+} FuzzyMatch;
+
+typedef struct {
+    int field;
+    int op;
+    float number;
+    char text[MAX_STRING];
+} Predicate;
+
+typedef struct {
+    int count;
+    Predicate predicates[MAX_PREDICATES];
+    int indexOrder;
+    int rangeStart;
+    int rangeEnd;
+    int lookup;
+    int lookupSlot;
+    int tree;
+    int treeCandidates;
+    int prefixPredicate;
+    float priceLow;
+    float priceHigh;
+    int priceLowStrict;
+    int priceHighStrict;
+} QueryPlan;
+
+typedef struct {
+    char name[BRANCH_NAME_LENGTH];
+} Branch;
+
+typedef struct {
+    int loanID;
+    int bookID;
+    int fromBranch;
+    int toBranch;
+    int copies;
+    time_t lentDate;
+    time_t returnDate;
+    int isReturned;
+} BranchLoan;
+
+typedef struct {
+    int branch;
+    const char *text;
+    Book *books;
+    int count;
+} ShardSearch;
+
+typedef struct {
+    int branch;
+    Book book;
+} CatalogMatch;
+
+typedef struct {
+    long long sequence;
+    long long timestamp;
+    int type;
+    int bookID;
+    int memberID;
+    int transactionID;
+    float amount;
+} Event;
+
+typedef struct {
+    int magic;
+    int capacity;
+    long long nextSequence;
+} EventRingHeader;
+
+typedef struct {
+    long pid;
+    time_t started;
+    char path[MAX_STRING];
+} SnapshotJob;
+
+typedef struct {
+    time_t when;
+    int transIndex;
+    int opens;
+} LoanDelta;
+
+typedef struct {
+    int id;
+    int head;
+    int tail;
+    int length;
+} LoanList;
+
+typedef struct {
+    time_t when;
+    int next;
+    int prev;
+    int bucket;
+} Reminder;
+
+typedef struct {
+    int version;
+    int transactionCount;
+    long long tick;
+    int heads[WHEEL_DUE + 1];
+    unsigned long long occupied[WHEEL_LEVELS];
+    Reminder entries[MAX_TRANSACTIONS * REMINDER_KINDS];
+} ReminderWheel;
+
+typedef struct {
+    unsigned long long generation;
+    int table;
+    int offset;
+    int size;
+} SharedRange;
+
+#ifndef _WIN32
+typedef struct {
+    int magic;
+    unsigned long long generation;
+    unsigned long long tableGenerations[SHARED_TABLE_COUNT];
+    pthread_mutex_t lock;
+    int bookCount;
+    int memberCount;
+    int transactionCount;
+    int holdCount;
+    Book books[MAX_BOOKS];
+    Member members[MAX_MEMBERS];
+    Transaction transactions[MAX_TRANSACTIONS];
+    CopyRow copyRows[MAX_BOOKS];
+    Hold holds[MAX_HOLDS];
+    unsigned long long bookGenerations[MAX_BOOKS];
+    unsigned long long memberGenerations[MAX_MEMBERS];
+    unsigned long long transactionGenerations[MAX_TRANSACTIONS];
+    unsigned long long copyGenerations[MAX_BOOKS];
+    unsigned long long holdGenerations[MAX_HOLDS];
+    int archivedBookCount;
+    int archivedMemberCount;
+    int retiredBookID;
+    int retiredMemberID;
+    Book archivedBooks[MAX_ARCHIVED_BOOKS];
+    Member archivedMembers[MAX_ARCHIVED_MEMBERS];
+    Analytics analytics;
+    Circulation circulation;
+    ReminderWheel reminders;
+    unsigned long long rangeCount;
+    unsigned long long rangeFloor;
+    SharedRange ranges[SHARED_RANGE_SLOTS];
+} SharedTables;
+#endif
+
+typedef struct {
+    int loanDays;
+    int fineStart[FINE_TIER_COUNT];
+    int fineEnd[FINE_TIER_COUNT];
+    float fineRate[FINE_TIER_COUNT];
+} LoanPolicy;
+
+typedef struct {
+    int rows;
+    unsigned int sums[CHECKSUM_BLOCKS];
+} ChecksumSet;
+
+typedef struct {
+    int from;
+    int to;
+    int bookLoans[MAX_BOOKS];
+    int bookStrays[MAX_BOOKS];
+    int memberLoans[MAX_MEMBERS];
+    float memberFines[MAX_MEMBERS];
+    int unknownBooks;
+    int unknownMembers;
+    int badDates;
+} FsckPartition;
+
+typedef struct {
+    int days;
+    int members;
+    int titles;
+    float arrivalRate;
+    float keepDays;
+    float lateShare;
+    float lateDays;
+    unsigned int seed;
+} SimulationConfig;
+
+typedef struct {
+    time_t when;
+    int memberIndex;
+    int transIndex;
+} SimulationEvent;
+
 typedef struct {
     char username[50];
     char password[50];
 } Admin;
 
+static const int fineTierStart[FINE_TIER_COUNT] = {0, 7, 14};
+static const float fineTierRate[FINE_TIER_COUNT] = {
+    FINE_PER_DAY, 2 * FINE_PER_DAY, 3 * FINE_PER_DAY
+};
+static const char *exportTableNames[EXPORT_TABLE_COUNT] = {
+    "books", "members", "transactions", "loans"
+};
+static const float textFieldWeight[TEXT_FIELD_COUNT] = {3.0f, 2.0f, 1.0f};
+static const char *reminderKindNames[REMINDER_KINDS] = {"due-tomorrow", "overdue"};
+static const char *tierNames[MEMBER_TIER_COUNT] = {"Student", "Faculty", "Staff"};
+static const char *copyStatusNames[] = {
+    "-", "Available", "On loan", "Reserved", "Damaged", "Lost", "Withdrawn"
+};
+static const char *libraryFiles[] = {
+    BOOKS_FILE, MEMBERS_FILE, TRANSACTIONS_FILE, COPIES_FILE, HOLDS_FILE, ARCHIVE_FILE,
+    ANALYTICS_FILE, CIRCULATION_FILE, FULLTEXT_FILE, EVENTS_FILE, CHECKSUMS_FILE,
+    REMINDERS_FILE, OUTBOX_FILE
+};
+static const char *checkedFiles[CHECKED_TABLE_COUNT] = {
+    BOOKS_FILE, MEMBERS_FILE, TRANSACTIONS_FILE, COPIES_FILE
+};
+static const size_t checkedRowSizes[CHECKED_TABLE_COUNT] = {
+    sizeof(Book), sizeof(Member), sizeof(Transaction), sizeof(CopyRow)
+};
+static const int checkedRowLimits[CHECKED_TABLE_COUNT] = {
+    MAX_BOOKS, MAX_MEMBERS, MAX_TRANSACTIONS, MAX_BOOKS
+};
+static const char *periodNames[PERIOD_COUNT] = {"daily", "weekly", "monthly"};
+static const int periodDefaultCount[PERIOD_COUNT] = {14, 12, 12};
+
 Book books[MAX_BOOKS];
 Member members[MAX_MEMBERS];
 Transaction transactions[MAX_TRANSACTIONS];
@@ -61,13 +691,133 @@ int bookCount = 0;
 int memberCount = 0;
 int transactionCount = 0;
 
+int bookSlotTable[ID_HASH_SIZE];
+int memberSlotTable[ID_HASH_SIZE];
+
+int bookOrder[BOOK_ORDER_COUNT][MAX_BOOKS];
+int bookOrderCount = 0;
+int memberOrder[MEMBER_ORDER_COUNT][MAX_MEMBERS];
+int memberOrderCount = 0;
+
+BTree bookTrees[BTREE_COUNT];
+
+Term terms[MAX_TERMS];
+int termCount = 0;
+int termHashTable[TERM_HASH_SIZE];
+Posting postings[MAX_POSTINGS];
+int postingCount = 0;
+int bookTermVersion[MAX_BOOKS];
+int memberTermVersion[MAX_MEMBERS];
+TextPosting textPostings[MAX_TEXT_POSTINGS];
+int textPostingCount = 0;
+unsigned short bookFieldLength[MAX_BOOKS][TEXT_FIELD_COUNT];
+long fieldLengthTotal[TEXT_FIELD_COUNT];
+int textDocumentCount = 0;
+int termIndexDirty = 0;
+
+Suggestion suggestions[MAX_SUGGESTIONS];
+int suggestionCount = 0;
+int suggestHashTable[SUGGEST_HASH_SIZE];
+TrieNode trieNodes[MAX_TRIE_NODES];
+int trieNodeCount = 0;
+int suggestRoot[SUGGEST_KIND_COUNT];
+int suggestDirty = 1;
+
+Branch branches[MAX_BRANCHES];
+int branchCount = 1;
+int currentBranch = 0;
+BranchLoan branchLoans[MAX_BRANCH_LOANS];
+int branchLoanCount = 0;
+
+FILE *eventFile = NULL;
+EventRingHeader eventHeader;
+
+SnapshotJob snapshotJobs[MAX_SNAPSHOT_JOBS];
+int snapshotJobCount = 0;
+
+int freeBookSlots[MAX_BOOKS];
+int freeBookCount = 0;
+int freeMemberSlots[MAX_MEMBERS];
+int freeMemberCount = 0;
+Book archivedBooks[MAX_ARCHIVED_BOOKS];
+int archivedBookCount = 0;
+Member archivedMembers[MAX_ARCHIVED_MEMBERS];
+int archivedMemberCount = 0;
+int retiredBookID = 0;
+int retiredMemberID = 0;
+
+CopyRow copyRows[MAX_BOOKS];
+unsigned long long copyAvailable[MAX_BOOKS];
+unsigned long long copyReserved[MAX_BOOKS];
+
+#ifndef _WIN32
+SharedTables *sharedTables = NULL;
+#endif
+time_t virtualClock = 0;
+LoanPolicy loanPolicies[MEMBER_TIER_COUNT][MAX_POLICY_CLASSES];
+int loanLimits[MEMBER_TIER_COUNT];
+char policyClasses[MAX_POLICY_CLASSES][MAX_STRING];
+int policyClassCount = 1;
+unsigned char bookPolicyClass[MAX_BOOKS];
+ReminderWheel reminders;
+int reminderDirty[MAX_TRANSACTIONS * REMINDER_KINDS];
+unsigned char reminderMarked[MAX_TRANSACTIONS * REMINDER_KINDS];
+int reminderDirtyCount = 0;
+int reminderRewrite = 1;
+unsigned long long sharedSeen = 0;
+int sharedDepth = 0;
+int sharedDirty = 0;
+SharedRange sharedPending[SHARED_RANGE_SLOTS];
+int sharedPendingCount = 0;
+
+LoanDelta loanDeltas[MAX_LOAN_DELTAS];
+int loanDeltaCount = 0;
+int loanCheckpointStart[MAX_LOAN_CHECKPOINTS + 1];
+int loanCheckpointPool[MAX_LOAN_CHECKPOINTS * MAX_TRANSACTIONS];
+int openLoanSet[MAX_TRANSACTIONS];
+int openLoanPosition[MAX_TRANSACTIONS];
+int openLoanCount = 0;
+int temporalDirty = 0;
+LoanList bookLoanLists[LOAN_LIST_HASH_SIZE];
+LoanList memberLoanLists[LOAN_LIST_HASH_SIZE];
+int bookDeltaNext[MAX_LOAN_DELTAS];
+int memberDeltaNext[MAX_LOAN_DELTAS];
+
+char renderBuffer[RENDER_BUFFER_SIZE];
+int renderLength = 0;
+int renderMode = RENDER_TABLE;
+FILE *renderOut = NULL;
+int exportColumn = 0;
+DateCacheEntry dateCache[DATE_CACHE_SIZE];
+
+Analytics analytics;
+Circulation circulation;
+DayCounts circulationTree[CIRCULATION_SERIES][CIRCULATION_DAYS + 1];
+
+Hold holds[MAX_HOLDS];
+int holdCount = 0;
+int holdQueueHead[MAX_BOOKS];
+int holdQueueTail[MAX_BOOKS];
+int holdQueueNext[MAX_HOLDS];
+int memberHoldHead[MAX_MEMBERS];
+int memberHoldNext[MAX_HOLDS];
+int readyHoldCount = 0;
+
 int fileExists(const char *filename);
+time_t libraryNow();
+void loadLibrary();
 void loadBooks();
 void saveBooks();
 void loadMembers();
 void saveMembers();
+void upgradeMembers(const MemberV1 *legacy, Member *out, int count);
 void loadTransactions();
+void stampLegacyLoans();
 void saveTransactions();
+unsigned int blockChecksum(const void *data, size_t size);
+void recordChecksums(int table, const void *rows, int count, int first, int last);
+void recordChecksumsAt(const char *path, int table, const void *rows, int count,
+                       int first, int last);
 void initializeAdmin();
 int verifyAdmin(char *username, char *password);
 
@@ -80,10 +830,125 @@ int generateTransactionID();
 void printHeader(const char *title);
 int getDaysDifference(time_t date1, time_t date2);
 
+void rebuildIDIndexes();
+void indexBookSlot(int slot);
+void indexMemberSlot(int slot);
+void unindexBookSlot(int slot);
+void unindexMemberSlot(int slot);
+int findBookSlot(int bookID);
+int findMemberSlot(int memberID);
+
+int compareFolded(const char *a, const char *b);
+int compareBookKeys(int order, int a, int availableA, int b, int availableB);
+int compareMemberKeys(int order, int a, int b);
+int compareBookCursor(int order, int slot, const char *key, int bookID);
+int compareMemberCursor(int order, int slot, const char *key, int memberID);
+void rebuildOrderIndexes();
+void reindexBook(int slot);
+void reindexMember(int slot);
+int bookPageStart(int order, const char *cursor);
+int memberPageStart(int order, const char *cursor);
+int parseBookOrder(const char *name);
+int parseMemberOrder(const char *name);
+
+unsigned long long foldedPrefix(const char *str);
+unsigned long long foldedPrefixEnd(const char *str);
+unsigned long long priceKey(float price);
+BTreeKey btreeKeyFor(int kind, int slot);
+int btreeCompare(const BTreeKey *key, unsigned long long prefix, int bookID);
+int btreeNewNode(BTree *tree, int leaf);
+int btreeInsertAt(int kind, int node, BTreeKey key, BTreeKey *upKey, int *upNode);
+void btreeInsertBook(int slot);
+void btreeRemoveBook(int slot);
+void rebuildBTree(int kind);
+void rebuildBTrees();
+BTreeCursor btreeSeek(int kind, unsigned long long prefix, int bookID);
+int btreeNext(int kind, BTreeCursor *cursor, unsigned long long *prefix);
+int startsWithFolded(const char *str, const char *prefix);
+
+int nextTerm(const char **text, char *term);
+void buildPeq(const char *pattern, unsigned long long *peq);
+int editDistance(const unsigned long long *peq, int m, const char *text);
+int findTerm(const char *term, int insert);
+void indexTerms(int kind, int slot, const char *text, int version);
+void indexBookTerms(int slot);
+void indexMemberTerms(int slot);
+void rebuildTermIndex();
+int fuzzyMaxEdits(int length);
+int bkSearch(const char *word, int maxEdits, int *matchTerms, int *matchDistances);
+int compareFuzzyMatches(const void *a, const void *b);
+int fuzzySearch(int kind, const char *query, FuzzyMatch *matches, int maxMatches);
+const char *bookField(int slot, int field);
+int collectBookText(int slot, int insert, int *termIDs, unsigned char (*tf)[TEXT_FIELD_COUNT]);
+void indexBookText(int slot, int version);
+void unindexBookTerms(int slot);
+int selectTopText(const int *slots, int n, const float *scores, TextMatch *top, int k);
+int fullTextSearch(const char *query, TextMatch *top, int k);
+void termIndexStamp(long long *stamp);
+void saveTermIndex();
+void loadTermIndex();
+int suggestionEntry(int kind, const char *text);
+int trieChild(int node, char key, int insert);
+void trieOffer(int node, int entry);
+void trieRaise(int node, int entry);
+void bumpSuggestion(int kind, const char *text);
+void rebuildSuggestions();
+int readKey();
+void drawSuggestions(const char *prompt, const char *text, int node);
+void readSuggested(const char *prompt, int kind, char *out);
+
+void renderBegin(FILE *out, int mode);
+void renderf(const char *format, ...);
+void renderFlush();
+void renderEnd();
+void formatDate(time_t date, char *out);
+int renderBooks(int order, const char *after, int limit, char *nextCursor);
+int renderMembers(int order, const char *after, int limit, char *nextCursor);
+int renderIssuedBooks(time_t now);
+int renderMemberHistory(int memberID);
+int renderMemberLoans(int memberID, time_t now);
+int openEventRing();
+void emitEvent(int type, int bookID, int memberID, int transactionID, float amount);
+long long readEvents(long long from, Event *out, int max, int *count, long long *oldest);
+int renderEvents(long long from, int follow);
+void renderPut(const char *text, int length);
+void exportField(const char *name, const char *value, int quoted);
+void exportText(const char *name, const char *value);
+void exportInt(const char *name, int value);
+void exportMoney(const char *name, float value);
+void exportDate(const char *name, time_t date);
+void exportEndRow();
+int parseExportTable(const char *name);
+int renderExport(int table, time_t now);
+void exportMenu();
+int runCommand(int argc, char *argv[]);
+float simulationRandom();
+float simulationExponential(float mean);
+int compareSimulationEvents(const void *a, const void *b);
+int checkpointSimulation(time_t *plannedReturn, time_t now);
+long libraryFileSize(const char *file);
+int renderSimulation(const SimulationConfig *config);
+int verifyChecksums(int table);
+void *aggregatePartition(void *arg);
+int repairCounters(const FsckPartition *totals);
+int renderFsck(int repair);
+
 void addBook();
 void viewAllBooks();
 void searchBook();
 void updateBook();
+int containsFolded(const char *haystack, const char *needle);
+int parseQuery(const char *text, QueryPlan *plan, char *error);
+int compareProbe(int order, int slot, const char *text, float number);
+int orderBound(int order, const char *text, float number, int upper);
+void planQuery(QueryPlan *plan);
+int filterBatch(const QueryPlan *plan, const int *candidates, int n, int *selected);
+BTreeCursor planTreeStart(const QueryPlan *plan);
+int planTreeInRange(const QueryPlan *plan, unsigned long long prefix);
+int executeQuery(QueryPlan *plan, int *results, int maxResults);
+int renderQuery(const char *text);
+int renderSearch(const char *text, int limit);
+void advancedQuery();
 void deleteBook();
 void bookManagementMenu();
 
@@ -93,27 +958,232 @@ void searchMember();
 void updateMember();
 void deleteMember();
 void memberManagementMenu();
+void rebuildFreeSlots();
+void loadArchive();
+void saveArchive();
+const Book *archivedBook(int bookID);
+const Member *archivedMember(int memberID);
+const Book *bookRecord(int bookID);
+const Member *memberRecord(int memberID);
+const char *bookTitleFor(int bookID);
+const char *memberNameFor(int memberID);
+int bookReferenced(int bookID);
+int memberReferenced(int memberID);
+int retireBookSlot(int slot);
+int retireMemberSlot(int slot);
+int allocateBookSlot();
+int allocateMemberSlot();
+int compactTables();
+void compactIfSparse();
+void loadCopies();
+void rebuildCopyBitmaps(int slot);
+void saveCopies();
+void saveCopyRange(const void *field, size_t size);
+void resetCopyRow(int slot);
+void setCopyStatus(int slot, int copy, int status);
+int addCopy(int slot);
+int takeCopy(int slot, int status);
+void syncCopies(int slot);
+int findCopy(int barcode, int *copy);
+int shelveCopy(int slot, int copy, time_t now);
+void manageCopies();
 
+int performIssue(int bookIndex, int memberIndex, int copy, time_t now);
+int issueCopy(int bookIndex, int memberIndex, int copy, time_t now);
+int performReturn(int transIndex, time_t now);
+int returnCopy(int transIndex, time_t now);
+int findOpenLoan(int bookID, int memberID);
 void issueBook();
 void returnBook();
+void deskMode();
 void viewIssuedBooks();
 void viewMemberHistory(int memberID);
-void calculateFine(Transaction *trans);
+int parseTier(const char *text);
+const char *nextPolicyToken(const char *text, char *out, int size);
+void defaultPolicy();
+int policyClassFor(const char *category, int create);
+int compilePolicyLine(const char *line, char *error);
+void loadPolicy();
+void classifyBook(int slot);
+void rebuildPolicyClasses();
+const LoanPolicy *loanPolicy(int bookIndex, int memberIndex);
+const LoanPolicy *transactionPolicy(const Transaction *trans);
+int renderPolicy();
+void calculateFine(Transaction *trans, const LoanPolicy *policy);
+float fineForDaysLate(const LoanPolicy *policy, int daysLate);
+int accrueOpenFines(time_t asOf, int *transIndex, float *fines);
+float accruedFinesForMember(int memberID, time_t asOf);
+time_t parseDate(const char *text);
+int renderLiabilities(time_t asOf);
+void outstandingLiabilitiesReport();
+int compareLoanDeltas(const void *a, const void *b);
+int compareInts(const void *a, const void *b);
+LoanList *loanList(LoanList *table, int id, int insert);
+void linkLoanDelta(LoanList *table, int *next, int id, int delta);
+void appendLoanDelta(int transIndex, int opens, time_t when);
+void recordLoanDelta(int transIndex, int opens, time_t when);
+void rebuildTemporalIndex();
+int loansDuring(time_t from, time_t to, int bookID, int memberID, int *out);
+int renderLoansDuring(time_t from, time_t to, int bookID, int memberID);
+void loansOnDateReport();
 void transactionMenu();
 
+unsigned int hashFolded(const char *str);
+void sketchAdd(SketchEntry *entries, int *size, int capacity,
+               int key, int labelID, int weight);
+AnalyticsPane *analyticsPane(time_t when);
+void recordIssueAnalytics(int bookIndex, int memberIndex, time_t when);
+void recordOverdueAnalytics(int bookIndex, time_t when);
+void recordCoBorrows(int bookIndex, int memberIndex, int save);
+void decayCoBorrows();
+int recommendBooks(int bookIndex, int memberIndex, int *out, int limit);
+int renderRecommendations(int bookIndex, int memberIndex, int limit);
+void rebuildAnalytics();
+void loadAnalytics();
+void saveAnalytics();
+void saveAnalyticsRange(const void *field, size_t size);
+int topN(int metric, int days, time_t now, SketchEntry *out, int limit);
+int renderTopN(int metric, int days, int limit);
+void popularityReport();
+long civilDay(int year, int month, int mday);
+void civilDate(long day, int *year, int *month, int *mday);
+long circulationDay(time_t when);
+int circulationCategory(const char *category, int create);
+void addDayCounts(DayCounts *to, const DayCounts *delta, int sign);
+void buildCirculationTree();
+void shiftCirculation(long day);
+void recordCirculation(const char *category, time_t when, int issues, int returns,
+                       float fines, int save);
+DayCounts circulationPrefix(int series, int count);
+DayCounts circulationRange(int series, long fromDay, long toDay);
+void rebuildCirculation();
+void loadCirculation();
+void saveCirculation();
+void saveCirculationRange(const void *field, size_t size);
+int parsePeriod(const char *name);
+int renderCirculation(int period, int count, long endDay, int category);
+void circulationReport();
+void renderStatistics();
+void viewStatistics();
+void renderSnapshotReport(time_t taken);
+int startSnapshotReport();
+void pollSnapshotReports(int wait);
+void snapshotReportMenu();
+
+long long reminderTick(time_t when);
+void markReminder(int entry);
+void clearReminderMarks();
+void linkReminder(int entry, int bucket);
+void unlinkReminder(int entry);
+void placeReminder(int entry);
+void cascadeReminders(int level, int slot);
+void advanceReminders(long long target);
+void scheduleReminders(int transIndex);
+void cancelReminders(int transIndex);
+void rebuildReminders(time_t now);
+void loadReminders();
+void saveReminders();
+int sendReminders(time_t until);
+void sendRemindersMenu();
+
+void loadHolds();
+void saveHolds();
+void rebuildHoldQueues();
+int compactHolds();
+int placeHold(int bookIndex, int memberIndex, time_t now);
+int dispatchHold(int bookIndex, time_t now);
+int findReadyHold(int bookIndex, int memberID);
+int expireHolds(time_t now);
+void releaseReservedCopy(int bookIndex, time_t now);
+void cancelHold(int holdIndex, time_t now);
+void cancelBookHolds(int bookIndex, time_t now);
+void cancelMemberHolds(int memberIndex, time_t now);
+int holdQueuePosition(int holdIndex);
+void placeHoldMenu(int memberID);
+void viewMyHolds(int memberID);
+void viewHoldQueue();
+void reportsMenu();
+
+void branchFilePath(int branch, const char *file, char *path);
+const char *dataPath(const char *file);
+void loadBranches();
+void saveBranches();
+int findBranch(const char *name);
+int branchForBookID(int bookID);
+int branchForMemberID(int memberID);
+void printOwningBranch(const char *what, int branch);
+int loadShardBooks(int branch, Book *out);
+int saveShardBooks(int branch, const Book *in, int count);
+void *searchShard(void *arg);
+int compareCatalogMatches(const void *a, const void *b);
+int catalogSearch(const char *text, CatalogMatch *out);
+int renderCatalog(const char *text);
+int renderBranches();
+int selectBranchArgument(int *argc, char *argv[]);
+int selectSharedArgument(int *argc, char *argv[]);
+int attachShared();
+char *sharedRangeTable(int table, int inShared);
+size_t sharedRangeSize(int table);
+void markSharedRange(int table, const void *field, size_t size);
+void markSharedAll();
+int pushRows(char *shared, const char *local, unsigned long long *generations,
+             int count, int fresh, size_t size, unsigned long long generation);
+int bookKeysChanged(const Book *a, const Book *b);
+int pullBookRows(unsigned long long seen);
+int pullMemberRows(unsigned long long seen);
+void pullTransactionRows(unsigned long long seen);
+void pullRanges(unsigned long long seen);
+void rebuildSharedState();
+void pullShared();
+void pushShared();
+void sharedBegin();
+void sharedEnd();
+void sharedRelease();
+void sharedRefresh();
+void chooseBranch();
+void addBranch();
+void loadBranchLoans();
+void saveBranchLoans();
+int lockBranchFile(const char *path);
+int tryBranchFile(const char *path, int *fd);
+void unlockBranchFile(int fd);
+void holdBranchBooks();
+int lockBranchShared(int branch, void **region);
+void unlockBranchShared(void *region, const Book *shard, int count, int slot);
+int moveShardCopies(int branch, const Book *book, int copies);
+void printMoveFailure(int branch, int moved);
+void lendToBranch();
+void returnBranchLoan();
+void viewBranchLoans();
+void branchMenu();
+
 void displayMenuRecursive(int menuType);
-int searchBookRecursive(int id, int left, int right);
-int searchMemberRecursive(int id, int left, int right);
 
 void adminMenu();
 void memberLoginMenu();
 int mainMenu();
 
-int main() {
-    loadBooks();
-    loadMembers();
-    loadTransactions();
+int main(int argc, char *argv[]) {
+    int shared = selectSharedArgument(&argc, argv);
+    loadBranches();
+    if (!selectBranchArgument(&argc, argv) && argc == 1 && branchCount > 1) {
+        chooseBranch();
+    }
+    loadBranchLoans();
+    if (!shared) holdBranchBooks();
+    
     initializeAdmin();
+    loadLibrary();
+    
+    if (shared && !attachShared()) {
+        fprintf(stderr, "Could not attach to %s\n", dataPath(SHARED_FILE));
+        return 1;
+    }
+    sharedRefresh();
+    
+    if (argc > 1) {
+        return runCommand(argc, argv);
+    }
     
     printf("\n");
     printf("╔════════════════════════════════════════════════════════════╗\n");
@@ -146,24 +1216,28 @@ int fileExists(const char *filename) {
 }
 
 void loadBooks() {
-    if (!fileExists(BOOKS_FILE)) {
+    if (!fileExists(dataPath(BOOKS_FILE))) {
         bookCount = 0;
         return;
     }
     
-    FILE *file = fopen(BOOKS_FILE, "rb");
+    FILE *file = fopen(dataPath(BOOKS_FILE), "rb");
     if (file == NULL) {
         printf("Error loading books!\n");
         return;
     }
     
-    fread(&bookCount, sizeof(int), 1, file);
-    fread(books, sizeof(Book), bookCount, file);
+    if (fread(&bookCount, sizeof(int), 1, file) != 1 || bookCount < 0 || bookCount > MAX_BOOKS) {
+        printf("Error loading books!\n");
+        bookCount = 0;
+    }
+    bookCount = (int)fread(books, sizeof(Book), bookCount, file);
     fclose(file);
 }
 
 void saveBooks() {
-    FILE *file = fopen(BOOKS_FILE, "wb");
+    sharedDirty |= 1 << SHARED_BOOKS;
+    FILE *file = fopen(dataPath(BOOKS_FILE), "wb");
     if (file == NULL) {
         printf("Error saving books!\n");
         return;
@@ -172,64 +1246,232 @@ void saveBooks() {
     fwrite(&bookCount, sizeof(int), 1, file);
     fwrite(books, sizeof(Book), bookCount, file);
     fclose(file);
+    recordChecksums(CHECKED_BOOKS, books, bookCount, 0, bookCount);
+    saveTermIndex();
 }
 
 void loadMembers() {
-    if (!fileExists(MEMBERS_FILE)) {
+    if (!fileExists(dataPath(MEMBERS_FILE))) {
         memberCount = 0;
         return;
     }
     
-    FILE *file = fopen(MEMBERS_FILE, "rb");
+    FILE *file = fopen(dataPath(MEMBERS_FILE), "rb");
     if (file == NULL) {
         printf("Error loading members!\n");
         return;
     }
     
-    fread(&memberCount, sizeof(int), 1, file);
-    fread(members, sizeof(Member), memberCount, file);
+    int version = 0;
+    fread(&version, sizeof(int), 1, file);
+    memberCount = version;
+    if (version < 0 && fread(&memberCount, sizeof(int), 1, file) != 1) {
+        memberCount = -1;
+    }
+    if (memberCount < 0 || memberCount > MAX_MEMBERS) {
+        printf("Error loading members!\n");
+        memberCount = 0;
+    }
+    
+    if (version >= 0) {
+        static MemberV1 legacy[MAX_MEMBERS];
+        memberCount = (int)fread(legacy, sizeof(MemberV1), memberCount, file);
+        upgradeMembers(legacy, members, memberCount);
+    } else {
+        memberCount = (int)fread(members, sizeof(Member), memberCount, file);
+    }
     fclose(file);
+    
+    for (int i = 0; i < memberCount; i++) {
+        if (members[i].tier < 0 || members[i].tier >= MEMBER_TIER_COUNT) {
+            members[i].tier = TIER_STUDENT;
+        }
+    }
 }
 
 void saveMembers() {
-    FILE *file = fopen(MEMBERS_FILE, "wb");
+    sharedDirty |= 1 << SHARED_MEMBERS;
+    FILE *file = fopen(dataPath(MEMBERS_FILE), "wb");
     if (file == NULL) {
         printf("Error saving members!\n");
         return;
     }
     
+    int version = -MEMBERS_VERSION;
+    fwrite(&version, sizeof(int), 1, file);
     fwrite(&memberCount, sizeof(int), 1, file);
     fwrite(members, sizeof(Member), memberCount, file);
     fclose(file);
+    recordChecksums(CHECKED_MEMBERS, members, memberCount, 0, memberCount);
+    saveTermIndex();
+}
+
+void upgradeMembers(const MemberV1 *legacy, Member *out, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i].memberID = legacy[i].memberID;
+        strcpy(out[i].name, legacy[i].name);
+        strcpy(out[i].email, legacy[i].email);
+        memcpy(out[i].phone, legacy[i].phone, sizeof(out[i].phone));
+        strcpy(out[i].address, legacy[i].address);
+        out[i].booksIssued = legacy[i].booksIssued;
+        out[i].totalFines = legacy[i].totalFines;
+        out[i].isActive = legacy[i].isActive;
+        out[i].tier = TIER_STUDENT;
+    }
 }
 
 void loadTransactions() {
-    if (!fileExists(TRANSACTIONS_FILE)) {
+    if (!fileExists(dataPath(TRANSACTIONS_FILE))) {
         transactionCount = 0;
         return;
     }
     
-    FILE *file = fopen(TRANSACTIONS_FILE, "rb");
+    FILE *file = fopen(dataPath(TRANSACTIONS_FILE), "rb");
     if (file == NULL) {
         printf("Error loading transactions!\n");
         return;
     }
     
-    fread(&transactionCount, sizeof(int), 1, file);
-    fread(transactions, sizeof(Transaction), transactionCount, file);
+    int version = 0;
+    fread(&version, sizeof(int), 1, file);
+    transactionCount = version;
+    if (version < 0 && fread(&transactionCount, sizeof(int), 1, file) != 1) {
+        transactionCount = -1;
+    }
+    if (transactionCount < 0 || transactionCount > MAX_TRANSACTIONS) {
+        printf("Error loading transactions!\n");
+        transactionCount = 0;
+    }
+    
+    if (version >= 0) {
+        static TransactionV1 legacy[MAX_TRANSACTIONS];
+        transactionCount = (int)fread(legacy, sizeof(TransactionV1), transactionCount, file);
+        for (int i = 0; i < transactionCount; i++) {
+            transactions[i].transactionID = legacy[i].transactionID;
+            transactions[i].bookID = legacy[i].bookID;
+            transactions[i].memberID = legacy[i].memberID;
+            transactions[i].issueDate = legacy[i].issueDate;
+            transactions[i].dueDate = legacy[i].dueDate;
+            transactions[i].returnDate = legacy[i].returnDate;
+            transactions[i].fine = legacy[i].fine;
+            transactions[i].isReturned = legacy[i].isReturned;
+            transactions[i].copyBarcode = 0;
+            transactions[i].tier = -1;
+        }
+    } else if (version == -2) {
+        static TransactionV2 legacy[MAX_TRANSACTIONS];
+        transactionCount = (int)fread(legacy, sizeof(TransactionV2), transactionCount, file);
+        for (int i = 0; i < transactionCount; i++) {
+            memcpy(&transactions[i], &legacy[i], sizeof(TransactionV2));
+            transactions[i].tier = -1;
+        }
+    } else {
+        transactionCount = (int)fread(transactions, sizeof(Transaction), transactionCount, file);
+    }
     fclose(file);
 }
 
+void stampLegacyLoans() {
+    int stamped = 0;
+    for (int i = 0; i < transactionCount; i++) {
+        Transaction *trans = &transactions[i];
+        if (trans->tier != -1) continue;
+        
+        const Book *book = bookRecord(trans->bookID);
+        const Member *member = memberRecord(trans->memberID);
+        trans->tier = member != NULL ? member->tier : TIER_STUDENT;
+        trans->policyClass = book != NULL ? policyClassFor(book->category, 0) : 0;
+        stamped++;
+    }
+    if (stamped > 0) saveTransactions();
+}
+
 void saveTransactions() {
-    FILE *file = fopen(TRANSACTIONS_FILE, "wb");
+    sharedDirty |= 1 << SHARED_TRANSACTIONS;
+    FILE *file = fopen(dataPath(TRANSACTIONS_FILE), "wb");
     if (file == NULL) {
         printf("Error saving transactions!\n");
         return;
     }
     
+    int version = -TRANSACTIONS_VERSION;
+    fwrite(&version, sizeof(int), 1, file);
     fwrite(&transactionCount, sizeof(int), 1, file);
     fwrite(transactions, sizeof(Transaction), transactionCount, file);
     fclose(file);
+    recordChecksums(CHECKED_TRANSACTIONS, transactions, transactionCount, 0, transactionCount);
+}
+
+unsigned int blockChecksum(const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void recordChecksums(int table, const void *rows, int count, int first, int last) {
+    recordChecksumsAt(dataPath(CHECKSUMS_FILE), table, rows, count, first, last);
+}
+
+void recordChecksumsAt(const char *path, int table, const void *rows, int count,
+                       int first, int last) {
+    FILE *file = fopen(path, "r+b");
+    if (file == NULL) {
+        ChecksumSet blank[CHECKED_TABLE_COUNT];
+        memset(blank, 0, sizeof(blank));
+        for (int t = 0; t < CHECKED_TABLE_COUNT; t++) {
+            blank[t].rows = CHECKSUMS_UNRECORDED;
+        }
+        
+        file = fopen(path, "w+b");
+        if (file == NULL) return;
+        int version = CHECKSUMS_VERSION;
+        fwrite(&version, sizeof(int), 1, file);
+        fwrite(blank, sizeof(ChecksumSet), CHECKED_TABLE_COUNT, file);
+    }
+    
+    size_t rowSize = checkedRowSizes[table];
+    long base = (long)(sizeof(int) + table * sizeof(ChecksumSet));
+    fseek(file, base, SEEK_SET);
+    fwrite(&count, sizeof(int), 1, file);
+    
+    if (last > count) last = count;
+    for (int block = first / CHECKSUM_BLOCK_ROWS; block * CHECKSUM_BLOCK_ROWS < last; block++) {
+        int start = block * CHECKSUM_BLOCK_ROWS;
+        int end = start + CHECKSUM_BLOCK_ROWS < count ? start + CHECKSUM_BLOCK_ROWS : count;
+        unsigned int sum = blockChecksum((const char *)rows + start * rowSize, (end - start) * rowSize);
+        fseek(file, base + (long)(sizeof(int) + block * sizeof(unsigned int)), SEEK_SET);
+        fwrite(&sum, sizeof(unsigned int), 1, file);
+    }
+    fclose(file);
+}
+
+time_t libraryNow() {
+    return virtualClock != 0 ? virtualClock : time(NULL);
+}
+
+void loadLibrary() {
+    loadPolicy();
+    loadBooks();
+    loadMembers();
+    loadTransactions();
+    rebuildTemporalIndex();
+    rebuildIDIndexes();
+    rebuildPolicyClasses();
+    rebuildOrderIndexes();
+    rebuildBTrees();
+    loadTermIndex();
+    loadAnalytics();
+    loadHolds();
+    loadCopies();
+    loadArchive();
+    stampLegacyLoans();
+    rebuildFreeSlots();
+    loadCirculation();
+    loadReminders();
 }
 
 void initializeAdmin() {
@@ -266,14 +1508,28 @@ int verifyAdmin(char *username, char *password) {
 }
 
 void clearScreen() {
-    #ifdef _WIN32
-        system("cls");
-    #else
-        system("clear");
-    #endif
+    static int ansi = -1;
+    
+    if (ansi == -1) {
+        ansi = isatty(fileno(stdout));
+        #ifdef _WIN32
+            HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+            DWORD consoleMode;
+            if (ansi && GetConsoleMode(console, &consoleMode)) {
+                SetConsoleMode(console, consoleMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+            }
+        #endif
+    }
+    
+    if (ansi) {
+        fputs("\033[H\033[2J", stdout);
+    }
 }
 
 void pauseScreen() {
+    sharedRelease();
+    if (!isatty(fileno(stdin))) return;
+    
     printf("\nPress Enter to continue...");
     getchar();
     getchar();
@@ -286,9 +1542,10 @@ void toLowerCase(char *str) {
 }
 
 int generateBookID() {
-    int maxID = 1000;
+    int maxID = 1000 + currentBranch * BRANCH_ID_SPAN;
+    if (retiredBookID > maxID) maxID = retiredBookID;
     for (int i = 0; i < bookCount; i++) {
-        if (books[i].bookID > maxID) {
+        if (books[i].bookID > maxID && branchForBookID(books[i].bookID) == currentBranch) {
             maxID = books[i].bookID;
         }
     }
@@ -296,9 +1553,10 @@ int generateBookID() {
 }
 
 int generateMemberID() {
-    int maxID = 2000;
+    int maxID = 2000 + currentBranch * BRANCH_ID_SPAN;
+    if (retiredMemberID > maxID) maxID = retiredMemberID;
     for (int i = 0; i < memberCount; i++) {
-        if (members[i].memberID > maxID) {
+        if (members[i].memberID > maxID && branchForMemberID(members[i].memberID) == currentBranch) {
             maxID = members[i].memberID;
         }
     }
@@ -316,6 +1574,7 @@ int generateTransactionID() {
 }
 
 void printHeader(const char *title) {
+    sharedRefresh();
     clearScreen();
     printf("\n╔════════════════════════════════════════════════════════════╗\n");
     printf("║  %-57s║\n", title);
@@ -326,595 +1585,7343 @@ int getDaysDifference(time_t date1, time_t date2) {
     return (int)difftime(date2, date1) / (60 * 60 * 24);
 }
 
-void addBook() {
-    printHeader("ADD NEW BOOK");
-    
-    if (bookCount >= MAX_BOOKS) {
-        printf("✗ Error: Maximum book limit reached!\n");
-        pauseScreen();
-        return;
+void indexBookSlot(int slot) {
+    unsigned int h = (unsigned int)books[slot].bookID & (ID_HASH_SIZE - 1);
+    while (bookSlotTable[h] != -1 && books[bookSlotTable[h]].bookID != books[slot].bookID) {
+        h = (h + 1) & (ID_HASH_SIZE - 1);
     }
+    bookSlotTable[h] = slot;
+}
+
+void indexMemberSlot(int slot) {
+    unsigned int h = (unsigned int)members[slot].memberID & (ID_HASH_SIZE - 1);
+    while (memberSlotTable[h] != -1 &&
+           members[memberSlotTable[h]].memberID != members[slot].memberID) {
+        h = (h + 1) & (ID_HASH_SIZE - 1);
+    }
+    memberSlotTable[h] = slot;
+}
+
+void rebuildIDIndexes() {
+    memset(bookSlotTable, -1, sizeof(bookSlotTable));
+    memset(memberSlotTable, -1, sizeof(memberSlotTable));
     
-    Book newBook;
-    newBook.bookID = generateBookID();
-    newBook.isActive = 1;
-    
-    printf("Enter Book Details:\n");
-    printf("─────────────────────\n\n");
-    
-    printf("Book ID (Auto-generated): %d\n", newBook.bookID);
+    for (int i = 0; i < bookCount; i++) {
+        indexBookSlot(i);
+    }
+    for (int i = 0; i < memberCount; i++) {
+        indexMemberSlot(i);
+    }
+}
+
+void unindexBookSlot(int slot) {
+    unsigned int h = (unsigned int)books[slot].bookID & (ID_HASH_SIZE - 1);
+    while (bookSlotTable[h] != slot) {
+        if (bookSlotTable[h] == -1) return;
+        h = (h + 1) & (ID_HASH_SIZE - 1);
+    }
     
-    printf("Title: ");
-    scanf(" %[^\n]", newBook.title);
+    unsigned int j = h;
+    while (1) {
+        bookSlotTable[h] = -1;
+        do {
+            j = (j + 1) & (ID_HASH_SIZE - 1);
+            if (bookSlotTable[j] == -1) return;
+        } while ((((j - ((unsigned int)books[bookSlotTable[j]].bookID & (ID_HASH_SIZE - 1)))
+                   & (ID_HASH_SIZE - 1)) < ((j - h) & (ID_HASH_SIZE - 1))));
+        bookSlotTable[h] = bookSlotTable[j];
+        h = j;
+    }
+}
+
+void unindexMemberSlot(int slot) {
+    unsigned int h = (unsigned int)members[slot].memberID & (ID_HASH_SIZE - 1);
+    while (memberSlotTable[h] != slot) {
+        if (memberSlotTable[h] == -1) return;
+        h = (h + 1) & (ID_HASH_SIZE - 1);
+    }
     
-    printf("Author: ");
-    scanf(" %[^\n]", newBook.author);
-    
-    printf("ISBN: ");
-    scanf(" %[^\n]", newBook.ISBN);
-    
-    printf("Category: ");
-    scanf(" %[^\n]", newBook.category);
-    
-    printf("Total Copies: ");
-    scanf("%d", &newBook.totalCopies);
-    
-    newBook.availableCopies = newBook.totalCopies;
-    
-    printf("Price: Rs. ");
-    scanf("%f", &newBook.price);
-    
-    books[bookCount++] = newBook;
-    saveBooks();
-    
-    printf("\n✓ Book added successfully with ID: %d\n", newBook.bookID);
-    pauseScreen();
+    unsigned int j = h;
+    while (1) {
+        memberSlotTable[h] = -1;
+        do {
+            j = (j + 1) & (ID_HASH_SIZE - 1);
+            if (memberSlotTable[j] == -1) return;
+        } while ((((j - ((unsigned int)members[memberSlotTable[j]].memberID & (ID_HASH_SIZE - 1)))
+                   & (ID_HASH_SIZE - 1)) < ((j - h) & (ID_HASH_SIZE - 1))));
+        memberSlotTable[h] = memberSlotTable[j];
+        h = j;
+    }
 }
 
-void viewAllBooks() {
-    printHeader("ALL BOOKS");
-    
-    if (bookCount == 0) {
-        printf("No books available in the library.\n");
-        pauseScreen();
-        return;
+int findBookSlot(int bookID) {
+    unsigned int h = (unsigned int)bookID & (ID_HASH_SIZE - 1);
+    while (bookSlotTable[h] != -1) {
+        if (books[bookSlotTable[h]].bookID == bookID) {
+            return bookSlotTable[h];
+        }
+        h = (h + 1) & (ID_HASH_SIZE - 1);
     }
-    
-    printf("%-8s %-30s %-25s %-15s %-8s\n", 
-           "ID", "Title", "Author", "ISBN", "Avail");
-    printf("────────────────────────────────────────────────────────────────────────────────\n");
-    
-    int activeCount = 0;
-    for (int i = 0; i < bookCount; i++) {
-        if (books[i].isActive) {
-            printf("%-8d %-30s %-25s %-15s %d/%d\n",
-                   books[i].bookID,
-                   books[i].title,
-                   books[i].author,
-                   books[i].ISBN,
-                   books[i].availableCopies,
-                   books[i].totalCopies);
-            activeCount++;
+    return -1;
+}
+
+int findMemberSlot(int memberID) {
+    unsigned int h = (unsigned int)memberID & (ID_HASH_SIZE - 1);
+    while (memberSlotTable[h] != -1) {
+        if (members[memberSlotTable[h]].memberID == memberID) {
+            return memberSlotTable[h];
         }
+        h = (h + 1) & (ID_HASH_SIZE - 1);
+    }
+    return -1;
+}
+
+int compareFolded(const char *a, const char *b) {
+    while (*a && tolower((unsigned char)*a) == tolower((unsigned char)*b)) {
+        a++;
+        b++;
+    }
+    return tolower((unsigned char)*a) - tolower((unsigned char)*b);
+}
+
+int compareBookKeys(int order, int a, int availableA, int b, int availableB) {
+    int diff = 0;
+    
+    if (order == ORDER_BY_TITLE) {
+        diff = compareFolded(books[a].title, books[b].title);
+    } else if (order == ORDER_BY_AUTHOR) {
+        diff = compareFolded(books[a].author, books[b].author);
+    } else if (order == ORDER_BY_AVAILABILITY) {
+        diff = availableB - availableA;
     }
     
-    printf("\nTotal Active Books: %d\n", activeCount);
-    pauseScreen();
+    if (diff == 0) {
+        diff = (books[a].bookID > books[b].bookID) - (books[a].bookID < books[b].bookID);
+    }
+    return diff;
 }
 
-void searchBook() {
-    printHeader("SEARCH BOOK");
+int compareMemberKeys(int order, int a, int b) {
+    int diff = 0;
     
-    printf("Search By:\n");
-    printf("1. Book ID\n");
-    printf("2. Title\n");
-    printf("3. Author\n");
-    printf("4. ISBN\n");
-    printf("\nChoice: ");
+    if (order == ORDER_BY_NAME) {
+        diff = compareFolded(members[a].name, members[b].name);
+    }
     
-    int choice;
-    scanf("%d", &choice);
+    if (diff == 0) {
+        diff = (members[a].memberID > members[b].memberID) -
+               (members[a].memberID < members[b].memberID);
+    }
+    return diff;
+}
+
+int compareBookCursor(int order, int slot, const char *key, int bookID) {
+    int diff = 0;
+    
+    if (order == ORDER_BY_TITLE) {
+        diff = compareFolded(books[slot].title, key);
+    } else if (order == ORDER_BY_AUTHOR) {
+        diff = compareFolded(books[slot].author, key);
+    } else if (order == ORDER_BY_AVAILABILITY) {
+        diff = atoi(key) - books[slot].availableCopies;
+    }
     
-    int found = 0;
+    if (diff == 0) {
+        diff = (books[slot].bookID > bookID) - (books[slot].bookID < bookID);
+    }
+    return diff;
+}
+
+int compareMemberCursor(int order, int slot, const char *key, int memberID) {
+    int diff = 0;
     
-    switch (choice) {
-        case 1: {
-            int id;
-            printf("Enter Book ID: ");
-            scanf("%d", &id);
-            
-            for (int i = 0; i < bookCount; i++) {
-                if (books[i].bookID == id && books[i].isActive) {
-                    printf("\n✓ Book Found:\n");
-                    printf("─────────────────\n");
-                    printf("ID          : %d\n", books[i].bookID);
-                    printf("Title       : %s\n", books[i].title);
-                    printf("Author      : %s\n", books[i].author);
-                    printf("ISBN        : %s\n", books[i].ISBN);
-                    printf("Category    : %s\n", books[i].category);
-                    printf("Available   : %d/%d\n", 
-                           books[i].availableCopies, books[i].totalCopies);
-                    printf("Price       : Rs. %.2f\n", books[i].price);
-                    found = 1;
-                    break;
-                }
+    if (order == ORDER_BY_NAME) {
+        diff = compareFolded(members[slot].name, key);
+    }
+    
+    if (diff == 0) {
+        diff = (members[slot].memberID > memberID) - (members[slot].memberID < memberID);
+    }
+    return diff;
+}
+
+void reindexBook(int slot) {
+    for (int order = 0; order < BOOK_ORDER_COUNT; order++) {
+        int *index = bookOrder[order];
+        int count = bookOrderCount;
+        
+        for (int i = 0; i < count; i++) {
+            if (index[i] == slot) {
+                memmove(&index[i], &index[i + 1], (count - i - 1) * sizeof(int));
+                count--;
+                break;
             }
-            break;
         }
-        case 2: {
-            char title[MAX_STRING];
-            printf("Enter Title: ");
-            scanf(" %[^\n]", title);
-            toLowerCase(title);
-            
-            printf("\n%-8s %-30s %-25s %-8s\n", "ID", "Title", "Author", "Avail");
-            printf("────────────────────────────────────────────────────────────────\n");
-            
-            for (int i = 0; i < bookCount; i++) {
-                if (books[i].isActive) {
-                    char bookTitle[MAX_STRING];
-                    strcpy(bookTitle, books[i].title);
-                    toLowerCase(bookTitle);
-                    
-                    if (strstr(bookTitle, title) != NULL) {
-                        printf("%-8d %-30s %-25s %d/%d\n",
-                               books[i].bookID, books[i].title, 
-                               books[i].author,
-                               books[i].availableCopies, books[i].totalCopies);
-                        found = 1;
-                    }
+        
+        if (books[slot].isActive) {
+            int lo = 0, hi = count;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (compareBookKeys(order, index[mid], books[index[mid]].availableCopies,
+                                    slot, books[slot].availableCopies) < 0) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
                 }
             }
-            break;
+            memmove(&index[lo + 1], &index[lo], (count - lo) * sizeof(int));
+            index[lo] = slot;
+            count++;
         }
-        case 3: {
-            char author[MAX_STRING];
-            printf("Enter Author: ");
-            scanf(" %[^\n]", author);
-            toLowerCase(author);
-            
-            printf("\n%-8s %-30s %-25s %-8s\n", "ID", "Title", "Author", "Avail");
-            printf("────────────────────────────────────────────────────────────────\n");
-            
-            for (int i = 0; i < bookCount; i++) {
-                if (books[i].isActive) {
-                    char bookAuthor[MAX_STRING];
-                    strcpy(bookAuthor, books[i].author);
-                    toLowerCase(bookAuthor);
-                    
-                    if (strstr(bookAuthor, author) != NULL) {
-                        printf("%-8d %-30s %-25s %d/%d\n",
-                               books[i].bookID, books[i].title, 
-                               books[i].author,
-                               books[i].availableCopies, books[i].totalCopies);
-                        found = 1;
-                    }
-                }
+        
+        if (order == BOOK_ORDER_COUNT - 1) {
+            bookOrderCount = count;
+        }
+    }
+}
+
+void reindexMember(int slot) {
+    for (int order = 0; order < MEMBER_ORDER_COUNT; order++) {
+        int *index = memberOrder[order];
+        int count = memberOrderCount;
+        
+        for (int i = 0; i < count; i++) {
+            if (index[i] == slot) {
+                memmove(&index[i], &index[i + 1], (count - i - 1) * sizeof(int));
+                count--;
+                break;
             }
-            break;
         }
-        case 4: {
-            char isbn[20];
-            printf("Enter ISBN: ");
-            scanf(" %[^\n]", isbn);
-            
-            for (int i = 0; i < bookCount; i++) {
-                if (strcmp(books[i].ISBN, isbn) == 0 && books[i].isActive) {
-                    printf("\n✓ Book Found:\n");
-                    printf("─────────────────\n");
-                    printf("ID          : %d\n", books[i].bookID);
-                    printf("Title       : %s\n", books[i].title);
-                    printf("Author      : %s\n", books[i].author);
-                    printf("ISBN        : %s\n", books[i].ISBN);
-                    printf("Available   : %d/%d\n", 
-                           books[i].availableCopies, books[i].totalCopies);
-                    found = 1;
-                    break;
+        
+        if (members[slot].isActive) {
+            int lo = 0, hi = count;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (compareMemberKeys(order, index[mid], slot) < 0) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
                 }
             }
-            break;
+            memmove(&index[lo + 1], &index[lo], (count - lo) * sizeof(int));
+            index[lo] = slot;
+            count++;
+        }
+        
+        if (order == MEMBER_ORDER_COUNT - 1) {
+            memberOrderCount = count;
         }
-        default:
-            printf("\n✗ Invalid choice!\n");
     }
+}
+
+void rebuildOrderIndexes() {
+    bookOrderCount = 0;
+    memberOrderCount = 0;
     
-    if (!found && choice >= 1 && choice <= 4) {
-        printf("\n✗ No books found!\n");
+    for (int i = 0; i < bookCount; i++) {
+        reindexBook(i);
+    }
+    for (int i = 0; i < memberCount; i++) {
+        reindexMember(i);
     }
-    
-    pauseScreen();
 }
 
-void updateBook() {
-    printHeader("UPDATE BOOK");
-    
-    int id;
-    printf("Enter Book ID to update: ");
-    scanf("%d", &id);
+int bookPageStart(int order, const char *cursor) {
+    if (cursor == NULL || cursor[0] == '\0') {
+        return 0;
+    }
     
-    int found = -1;
-    for (int i = 0; i < bookCount; i++) {
-        if (books[i].bookID == id && books[i].isActive) {
-            found = i;
-            break;
+    char *key = NULL;
+    int lastID = (int)strtol(cursor, &key, 10);
+    if (*key == ':') {
+        key++;
+    } else {
+        int cursorSlot = findBookSlot(lastID);
+        if (cursorSlot == -1) {
+            return bookOrderCount;
         }
+        static char available[12];
+        snprintf(available, sizeof(available), "%d", books[cursorSlot].availableCopies);
+        key = order == ORDER_BY_TITLE ? books[cursorSlot].title :
+              order == ORDER_BY_AUTHOR ? books[cursorSlot].author : available;
     }
     
-    if (found == -1) {
-        printf("\n✗ Book not found!\n");
-        pauseScreen();
-        return;
+    int *index = bookOrder[order];
+    int lo = 0, hi = bookOrderCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (compareBookCursor(order, index[mid], key, lastID) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
-    
-    printf("\nCurrent Details:\n");
-    printf("─────────────────\n");
-    printf("Title       : %s\n", books[found].title);
-    printf("Author      : %s\n", books[found].author);
-    printf("ISBN        : %s\n", books[found].ISBN);
-    printf("Category    : %s\n", books[found].category);
-    printf("Total Copies: %d\n", books[found].totalCopies);
-    printf("Price       : Rs. %.2f\n", books[found].price);
-    
-    printf("\nEnter New Details (press Enter to keep current):\n");
-    printf("─────────────────────────────────────────────────\n");
-    
-    char input[MAX_STRING];
-    
-    printf("Title [%s]: ", books[found].title);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(books[found].title, input);
-    
-    printf("Author [%s]: ", books[found].author);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(books[found].author, input);
-    
-    printf("Category [%s]: ", books[found].category);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(books[found].category, input);
-    
-    printf("Price [%.2f]: ", books[found].price);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) books[found].price = atof(input);
-    
-    saveBooks();
-    printf("\n✓ Book updated successfully!\n");
-    pauseScreen();
+    return lo;
 }
 
-void deleteBook() {
-    printHeader("DELETE BOOK");
+int memberPageStart(int order, const char *cursor) {
+    if (cursor == NULL || cursor[0] == '\0') {
+        return 0;
+    }
     
-    int id;
-    printf("Enter Book ID to delete: ");
-    scanf("%d", &id);
+    char *key = NULL;
+    int lastID = (int)strtol(cursor, &key, 10);
+    if (*key == ':') {
+        key++;
+    } else {
+        int cursorSlot = findMemberSlot(lastID);
+        if (cursorSlot == -1) {
+            return memberOrderCount;
+        }
+        key = members[cursorSlot].name;
+    }
     
-    int found = -1;
-    for (int i = 0; i < bookCount; i++) {
-        if (books[i].bookID == id && books[i].isActive) {
-            found = i;
-            break;
+    int *index = memberOrder[order];
+    int lo = 0, hi = memberOrderCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (compareMemberCursor(order, index[mid], key, lastID) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    return lo;
+}
+
+int parseBookOrder(const char *name) {
+    if (strcmp(name, "title") == 0) return ORDER_BY_TITLE;
+    if (strcmp(name, "author") == 0) return ORDER_BY_AUTHOR;
+    if (strcmp(name, "availability") == 0) return ORDER_BY_AVAILABILITY;
+    return ORDER_BY_ID;
+}
+
+int parseMemberOrder(const char *name) {
+    if (strcmp(name, "name") == 0) return ORDER_BY_NAME;
+    return ORDER_BY_ID;
+}
+
+unsigned long long foldedPrefix(const char *str) {
+    unsigned long long prefix = 0;
+    int i = 0;
+    for (; i < 8 && str[i]; i++) {
+        prefix = (prefix << 8) | (unsigned char)tolower((unsigned char)str[i]);
+    }
+    return i == 0 ? 0 : prefix << (8 * (8 - i));
+}
+
+unsigned long long foldedPrefixEnd(const char *str) {
+    int length = (int)strlen(str);
+    if (length >= 8) {
+        return foldedPrefix(str);
+    }
+    return foldedPrefix(str) | (~0ULL >> (8 * length));
+}
+
+unsigned long long priceKey(float price) {
+    unsigned int bits;
+    memcpy(&bits, &price, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+BTreeKey btreeKeyFor(int kind, int slot) {
+    BTreeKey key;
+    key.slot = slot;
+    key.bookID = books[slot].bookID;
     
-    if (found == -1) {
-        printf("\n✗ Book not found!\n");
-        pauseScreen();
-        return;
+    if (kind == BTREE_PRICE) {
+        key.prefix = priceKey(books[slot].price);
+    } else {
+        key.prefix = foldedPrefix(kind == BTREE_TITLE ? books[slot].title : books[slot].author);
+    }
+    return key;
+}
+
+int btreeCompare(const BTreeKey *key, unsigned long long prefix, int bookID) {
+    if (key->prefix != prefix) {
+        return key->prefix < prefix ? -1 : 1;
     }
+    return (key->bookID > bookID) - (key->bookID < bookID);
+}
+
+int btreeNewNode(BTree *tree, int leaf) {
+    int node = tree->nodeCount++;
+    tree->nodes[node].count = 0;
+    tree->nodes[node].leaf = leaf;
+    tree->nodes[node].next = -1;
+    return node;
+}
+
+int btreeInsertAt(int kind, int node, BTreeKey key, BTreeKey *upKey, int *upNode) {
+    BTree *tree = &bookTrees[kind];
+    BTreeNode *n = &tree->nodes[node];
     
-    if (books[found].availableCopies < books[found].totalCopies) {
-        printf("\n✗ Cannot delete! Book has been issued to members.\n");
-        pauseScreen();
-        return;
+    int pos = 0;
+    while (pos < n->count && btreeCompare(&n->keys[pos], key.prefix, key.bookID) <= 0) {
+        pos++;
     }
     
-    printf("\nBook: %s by %s\n", books[found].title, books[found].author);
-    printf("Are you sure you want to delete? (y/n): ");
+    if (n->leaf) {
+        memmove(&n->keys[pos + 1], &n->keys[pos], (n->count - pos) * sizeof(BTreeKey));
+        n->keys[pos] = key;
+        n->count++;
+    } else {
+        BTreeKey childKey;
+        int childNode;
+        if (!btreeInsertAt(kind, n->children[pos], key, &childKey, &childNode)) {
+            return 0;
+        }
+        n = &tree->nodes[node];
+        memmove(&n->keys[pos + 1], &n->keys[pos], (n->count - pos) * sizeof(BTreeKey));
+        memmove(&n->children[pos + 2], &n->children[pos + 1],
+                (n->count - pos) * sizeof(int));
+        n->keys[pos] = childKey;
+        n->children[pos + 1] = childNode;
+        n->count++;
+    }
     
-    char confirm;
-    scanf(" %c", &confirm);
+    if (n->count <= BTREE_ORDER) {
+        return 0;
+    }
     
-    if (confirm == 'y' || confirm == 'Y') {
-        books[found].isActive = 0;
-        saveBooks();
-        printf("\n✓ Book deleted successfully!\n");
+    int right = btreeNewNode(tree, n->leaf);
+    n = &tree->nodes[node];
+    BTreeNode *r = &tree->nodes[right];
+    int mid = n->count / 2;
+    
+    if (n->leaf) {
+        r->count = n->count - mid;
+        memcpy(r->keys, &n->keys[mid], r->count * sizeof(BTreeKey));
+        r->next = n->next;
+        n->next = right;
+        n->count = mid;
+        *upKey = r->keys[0];
     } else {
-        printf("\n✓ Deletion cancelled.\n");
+        *upKey = n->keys[mid];
+        r->count = n->count - mid - 1;
+        memcpy(r->keys, &n->keys[mid + 1], r->count * sizeof(BTreeKey));
+        memcpy(r->children, &n->children[mid + 1], (r->count + 1) * sizeof(int));
+        n->count = mid;
     }
-    
-    pauseScreen();
+    *upNode = right;
+    return 1;
 }
 
-void bookManagementMenu() {
-    while (1) {
-        printHeader("BOOK MANAGEMENT");
-        
-        printf("1. Add New Book\n");
-        printf("2. View All Books\n");
-        printf("3. Search Book\n");
-        printf("4. Update Book\n");
-        printf("5. Delete Book\n");
-        printf("6. Back to Main Menu\n");
-        printf("\nChoice: ");
+void btreeInsertBook(int slot) {
+    for (int kind = 0; kind < BTREE_COUNT; kind++) {
+        BTree *tree = &bookTrees[kind];
+        if (tree->nodeCount > BTREE_MAX_NODES - 8) {
+            rebuildBTree(kind);
+            continue;
+        }
         
-        int choice;
-        scanf("%d", &choice);
+        BTreeKey upKey;
+        int upNode;
+        if (btreeInsertAt(kind, tree->root, btreeKeyFor(kind, slot), &upKey, &upNode)) {
+            int root = btreeNewNode(tree, 0);
+            tree->nodes[root].count = 1;
+            tree->nodes[root].keys[0] = upKey;
+            tree->nodes[root].children[0] = tree->root;
+            tree->nodes[root].children[1] = upNode;
+            tree->root = root;
+        }
+    }
+}
+
+void btreeRemoveBook(int slot) {
+    for (int kind = 0; kind < BTREE_COUNT; kind++) {
+        BTree *tree = &bookTrees[kind];
+        BTreeKey key = btreeKeyFor(kind, slot);
+        BTreeCursor cursor = btreeSeek(kind, key.prefix, key.bookID);
         
-        switch (choice) {
-            case 1: addBook(); break;
-            case 2: viewAllBooks(); break;
-            case 3: searchBook(); break;
-            case 4: updateBook(); break;
-            case 5: deleteBook(); break;
-            case 6: return;
-            default:
-                printf("\n✗ Invalid choice!\n");
-                pauseScreen();
+        for (int node = cursor.node; node != -1; node = tree->nodes[node].next) {
+            BTreeNode *n = &tree->nodes[node];
+            int pos = node == cursor.node ? cursor.pos : 0;
+            if (pos < n->count) {
+                if (n->keys[pos].slot == slot) {
+                    memmove(&n->keys[pos], &n->keys[pos + 1],
+                            (n->count - pos - 1) * sizeof(BTreeKey));
+                    n->count--;
+                }
+                break;
+            }
         }
     }
 }
 
-void addMember() {
-    printHeader("ADD NEW MEMBER");
+void rebuildBTree(int kind) {
+    BTree *tree = &bookTrees[kind];
+    tree->nodeCount = 0;
+    tree->root = btreeNewNode(tree, 1);
     
-    if (memberCount >= MAX_MEMBERS) {
-        printf("✗ Error: Maximum member limit reached!\n");
-        pauseScreen();
-        return;
+    for (int i = 0; i < bookCount; i++) {
+        if (!books[i].isActive) continue;
+        
+        BTreeKey upKey;
+        int upNode;
+        if (btreeInsertAt(kind, tree->root, btreeKeyFor(kind, i), &upKey, &upNode)) {
+            int root = btreeNewNode(tree, 0);
+            tree->nodes[root].count = 1;
+            tree->nodes[root].keys[0] = upKey;
+            tree->nodes[root].children[0] = tree->root;
+            tree->nodes[root].children[1] = upNode;
+            tree->root = root;
+        }
+    }
+}
+
+void rebuildBTrees() {
+    for (int kind = 0; kind < BTREE_COUNT; kind++) {
+        rebuildBTree(kind);
+    }
+}
+
+BTreeCursor btreeSeek(int kind, unsigned long long prefix, int bookID) {
+    BTree *tree = &bookTrees[kind];
+    int node = tree->root;
+    
+    while (!tree->nodes[node].leaf) {
+        BTreeNode *n = &tree->nodes[node];
+        int pos = 0;
+        while (pos < n->count && btreeCompare(&n->keys[pos], prefix, bookID) <= 0) {
+            pos++;
+        }
+        node = n->children[pos];
     }
     
-    Member newMember;
-    newMember.memberID = generateMemberID();
-    newMember.booksIssued = 0;
-    newMember.totalFines = 0.0;
-    newMember.isActive = 1;
-    
-    printf("Enter Member Details:\n");
-    printf("─────────────────────\n\n");
-    
-    printf("Member ID (Auto-generated): %d\n", newMember.memberID);
-    
-    printf("Name: ");
-    scanf(" %[^\n]", newMember.name);
-    
-    printf("Email: ");
-    scanf(" %[^\n]", newMember.email);
-    
-    printf("Phone: ");
-    scanf(" %[^\n]", newMember.phone);
-    
-    printf("Address: ");
-    scanf(" %[^\n]", newMember.address);
-    
-    members[memberCount++] = newMember;
-    saveMembers();
+    BTreeNode *n = &tree->nodes[node];
+    int pos = 0;
+    while (pos < n->count && btreeCompare(&n->keys[pos], prefix, bookID) < 0) {
+        pos++;
+    }
     
-    printf("\n✓ Member registered successfully with ID: %d\n", newMember.memberID);
-    pauseScreen();
+    BTreeCursor cursor = {node, pos};
+    return cursor;
 }
 
-void viewAllMembers() {
-    printHeader("ALL MEMBERS");
-    
-    if (memberCount == 0) {
-        printf("No members registered.\n");
-        pauseScreen();
+int btreeNext(int kind, BTreeCursor *cursor, unsigned long long *prefix) {
+    BTree *tree = &bookTrees[kind];
+    while (cursor->node != -1) {
+        BTreeNode *n = &tree->nodes[cursor->node];
+        if (cursor->pos < n->count) {
+            *prefix = n->keys[cursor->pos].prefix;
+            return n->keys[cursor->pos++].slot;
+        }
+        cursor->node = n->next;
+        cursor->pos = 0;
+    }
+    return -1;
+}
+
+int startsWithFolded(const char *str, const char *prefix) {
+    for (; *prefix; str++, prefix++) {
+        if (tolower((unsigned char)*str) != (unsigned char)*prefix) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int nextTerm(const char **text, char *term) {
+    const char *p = *text;
+    while (*p && !isalnum((unsigned char)*p)) p++;
+    
+    int length = 0;
+    for (; isalnum((unsigned char)*p); p++) {
+        if (length < TERM_LENGTH - 1) {
+            term[length++] = (char)tolower((unsigned char)*p);
+        }
+    }
+    term[length] = '\0';
+    *text = p;
+    return length;
+}
+
+void buildPeq(const char *pattern, unsigned long long *peq) {
+    memset(peq, 0, 256 * sizeof(unsigned long long));
+    for (int i = 0; pattern[i]; i++) {
+        peq[(unsigned char)pattern[i]] |= 1ULL << i;
+    }
+}
+
+int editDistance(const unsigned long long *peq, int m, const char *text) {
+    if (m == 0) return (int)strlen(text);
+    
+    unsigned long long pv = ~0ULL, mv = 0, last = 1ULL << (m - 1);
+    int score = m;
+    
+    for (; *text; text++) {
+        unsigned long long eq = peq[(unsigned char)*text];
+        unsigned long long xv = eq | mv;
+        unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+        unsigned long long ph = mv | ~(xh | pv);
+        unsigned long long mh = pv & xh;
+        
+        score += (ph & last) != 0;
+        score -= (mh & last) != 0;
+        
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+int findTerm(const char *term, int insert) {
+    unsigned int h = hashFolded(term) & (TERM_HASH_SIZE - 1);
+    while (termHashTable[h] != -1) {
+        if (strcmp(terms[termHashTable[h]].text, term) == 0) {
+            return termHashTable[h];
+        }
+        h = (h + 1) & (TERM_HASH_SIZE - 1);
+    }
+    if (!insert || termCount == MAX_TERMS) return -1;
+    
+    int t = termCount++;
+    strcpy(terms[t].text, term);
+    terms[t].child = -1;
+    terms[t].sibling = -1;
+    terms[t].edge = 0;
+    terms[t].postings = -1;
+    terms[t].textPostings = -1;
+    terms[t].documentFrequency = 0;
+    terms[t].maxWeight = 0;
+    termHashTable[h] = t;
+    
+    if (t > 0) {
+        unsigned long long peq[256];
+        buildPeq(term, peq);
+        int m = (int)strlen(term);
+        int node = 0;
+        
+        while (1) {
+            int d = editDistance(peq, m, terms[node].text);
+            int child = terms[node].child;
+            while (child != -1 && terms[child].edge != d) {
+                child = terms[child].sibling;
+            }
+            if (child == -1) {
+                terms[t].edge = d;
+                terms[t].sibling = terms[node].child;
+                terms[node].child = t;
+                break;
+            }
+            node = child;
+        }
+    }
+    return t;
+}
+
+void indexTerms(int kind, int slot, const char *text, int version) {
+    char term[TERM_LENGTH];
+    while (nextTerm(&text, term) > 0) {
+        int t = findTerm(term, 1);
+        if (t == -1 || postingCount == MAX_POSTINGS) continue;
+        
+        Posting *p = &postings[postingCount];
+        p->slot = slot;
+        p->kind = kind;
+        p->version = version;
+        p->next = terms[t].postings;
+        terms[t].postings = postingCount++;
+    }
+}
+
+void indexBookTerms(int slot) {
+    if (postingCount > MAX_POSTINGS - MAX_STRING ||
+        textPostingCount > MAX_TEXT_POSTINGS - MAX_DOC_TERMS) {
+        rebuildTermIndex();
         return;
     }
+    int version = ++bookTermVersion[slot];
+    indexTerms(TERM_TITLE, slot, books[slot].title, version);
+    indexTerms(TERM_AUTHOR, slot, books[slot].author, version);
+    indexBookText(slot, version);
+    termIndexDirty = 1;
+    suggestDirty = 1;
+}
+
+void indexMemberTerms(int slot) {
+    if (postingCount > MAX_POSTINGS - MAX_STRING) {
+        rebuildTermIndex();
+        return;
+    }
+    indexTerms(TERM_MEMBER, slot, members[slot].name, ++memberTermVersion[slot]);
+    termIndexDirty = 1;
+    suggestDirty = 1;
+}
+
+void rebuildTermIndex() {
+    termCount = 0;
+    postingCount = 0;
+    textPostingCount = 0;
+    textDocumentCount = 0;
+    memset(termHashTable, -1, sizeof(termHashTable));
+    memset(fieldLengthTotal, 0, sizeof(fieldLengthTotal));
     
-    printf("%-8s %-25s %-30s %-15s %-8s\n", 
-           "ID", "Name", "Email", "Phone", "Issued");
-    printf("────────────────────────────────────────────────────────────────────────────────\n");
-    
-    int activeCount = 0;
+    for (int i = 0; i < bookCount; i++) {
+        if (books[i].isActive) {
+            int version = ++bookTermVersion[i];
+            indexTerms(TERM_TITLE, i, books[i].title, version);
+            indexTerms(TERM_AUTHOR, i, books[i].author, version);
+            indexBookText(i, version);
+        }
+    }
     for (int i = 0; i < memberCount; i++) {
         if (members[i].isActive) {
-            printf("%-8d %-25s %-30s %-15s %-8d\n",
-                   members[i].memberID,
-                   members[i].name,
-                   members[i].email,
-                   members[i].phone,
-                   members[i].booksIssued);
-            activeCount++;
+            indexTerms(TERM_MEMBER, i, members[i].name, ++memberTermVersion[i]);
         }
     }
-    
-    printf("\nTotal Active Members: %d\n", activeCount);
-    pauseScreen();
+    termIndexDirty = 1;
 }
 
-void searchMember() {
-    printHeader("SEARCH MEMBER");
+int fuzzyMaxEdits(int length) {
+    return length <= 2 ? 0 : length <= 5 ? 1 : 2;
+}
+
+int bkSearch(const char *word, int maxEdits, int *matchTerms, int *matchDistances) {
+    if (termCount == 0) return 0;
+    
+    unsigned long long peq[256];
+    buildPeq(word, peq);
+    int m = (int)strlen(word);
+    
+    int stack[MAX_TERMS];
+    int top = 0, count = 0;
+    stack[top++] = 0;
+    
+    while (top > 0) {
+        int node = stack[--top];
+        int d = editDistance(peq, m, terms[node].text);
+        if (d <= maxEdits) {
+            matchTerms[count] = node;
+            matchDistances[count++] = d;
+        }
+        for (int child = terms[node].child; child != -1; child = terms[child].sibling) {
+            if (terms[child].edge >= d - maxEdits && terms[child].edge <= d + maxEdits) {
+                stack[top++] = child;
+            }
+        }
+    }
+    return count;
+}
+
+int compareFuzzyMatches(const void *a, const void *b) {
+    const FuzzyMatch *x = a, *y = b;
+    if (x->contains != y->contains) return y->contains - x->contains;
+    if (x->distance != y->distance) return x->distance - y->distance;
+    return x->id - y->id;
+}
+
+int fuzzySearch(int kind, const char *query, FuzzyMatch *matches, int maxMatches) {
+    static int stamp[MAX_BOOKS], score[MAX_BOOKS], hits[MAX_BOOKS];
+    static int lastWord[MAX_BOOKS], wordDistance[MAX_BOOKS], touched[MAX_BOOKS];
+    static int listed[MAX_BOOKS];
+    static int currentStamp = 0;
+    static int matchTerms[MAX_TERMS], matchDistances[MAX_TERMS];
+    
+    currentStamp++;
+    int touchedCount = 0, words = 0, count = 0;
+    char word[TERM_LENGTH];
+    
+    int slots = kind == TERM_MEMBER ? memberCount : bookCount;
+    for (int slot = 0; slot < slots && count < maxMatches; slot++) {
+        const char *text = kind == TERM_MEMBER ? members[slot].name :
+                           kind == TERM_TITLE ? books[slot].title : books[slot].author;
+        int active = kind == TERM_MEMBER ? members[slot].isActive : books[slot].isActive;
+        if (active && containsFolded(text, query)) {
+            listed[slot] = currentStamp;
+            matches[count].slot = slot;
+            matches[count].id = kind == TERM_MEMBER ? members[slot].memberID : books[slot].bookID;
+            matches[count].contains = 1;
+            matches[count++].distance = 0;
+        }
+    }
     
-    printf("Search By:\n");
-    printf("1. Member ID\n");
-    printf("2. Name\n");
-    printf("\nChoice: ");
+    while (words < MAX_QUERY_TERMS && nextTerm(&query, word) > 0) {
+        int n = bkSearch(word, fuzzyMaxEdits((int)strlen(word)), matchTerms, matchDistances);
+        
+        for (int i = 0; i < n; i++) {
+            for (int p = terms[matchTerms[i]].postings; p != -1; p = postings[p].next) {
+                int slot = postings[p].slot;
+                if (postings[p].kind != kind) continue;
+                if (kind == TERM_MEMBER
+                        ? !members[slot].isActive || memberTermVersion[slot] != postings[p].version
+                        : !books[slot].isActive || bookTermVersion[slot] != postings[p].version) {
+                    continue;
+                }
+                
+                if (stamp[slot] != currentStamp) {
+                    stamp[slot] = currentStamp;
+                    score[slot] = 0;
+                    hits[slot] = 0;
+                    lastWord[slot] = -1;
+                    touched[touchedCount++] = slot;
+                }
+                if (lastWord[slot] != words) {
+                    lastWord[slot] = words;
+                    wordDistance[slot] = matchDistances[i];
+                    score[slot] += matchDistances[i];
+                    hits[slot]++;
+                } else if (matchDistances[i] < wordDistance[slot]) {
+                    score[slot] -= wordDistance[slot] - matchDistances[i];
+                    wordDistance[slot] = matchDistances[i];
+                }
+            }
+        }
+        words++;
+    }
     
-    int choice;
-    scanf("%d", &choice);
+    for (int i = 0; i < touchedCount && count < maxMatches; i++) {
+        int slot = touched[i];
+        if (hits[slot] == words && listed[slot] != currentStamp) {
+            matches[count].slot = slot;
+            matches[count].id = kind == TERM_MEMBER ? members[slot].memberID : books[slot].bookID;
+            matches[count].contains = 0;
+            matches[count++].distance = score[slot];
+        }
+    }
     
-    int found = 0;
+    qsort(matches, count, sizeof(FuzzyMatch), compareFuzzyMatches);
+    return count;
+}
+
+const char *bookField(int slot, int field) {
+    return field == 0 ? books[slot].title : field == 1 ? books[slot].author : books[slot].category;
+}
+
+int collectBookText(int slot, int insert, int *termIDs, unsigned char (*tf)[TEXT_FIELD_COUNT]) {
+    int count = 0;
+    char term[TERM_LENGTH];
     
-    switch (choice) {
-        case 1: {
-            int id;
-            printf("Enter Member ID: ");
-            scanf("%d", &id);
+    for (int field = 0; field < TEXT_FIELD_COUNT; field++) {
+        const char *text = bookField(slot, field);
+        int length = 0;
+        
+        while (nextTerm(&text, term) > 0) {
+            length++;
+            int t = findTerm(term, insert);
+            if (t == -1) continue;
             
-            for (int i = 0; i < memberCount; i++) {
-                if (members[i].memberID == id && members[i].isActive) {
-                    printf("\n✓ Member Found:\n");
-                    printf("─────────────────\n");
-                    printf("ID          : %d\n", members[i].memberID);
-                    printf("Name        : %s\n", members[i].name);
-                    printf("Email       : %s\n", members[i].email);
-                    printf("Phone       : %s\n", members[i].phone);
-                    printf("Address     : %s\n", members[i].address);
-                    printf("Books Issued: %d\n", members[i].booksIssued);
-                    printf("Total Fines : Rs. %.2f\n", members[i].totalFines);
-                    found = 1;
-                    break;
-                }
+            int i = 0;
+            while (i < count && termIDs[i] != t) i++;
+            if (i == count) {
+                if (count == MAX_DOC_TERMS) continue;
+                termIDs[count] = t;
+                memset(tf[count++], 0, TEXT_FIELD_COUNT);
             }
-            break;
+            if (tf[i][field] < 255) tf[i][field]++;
         }
-        case 2: {
-            char name[MAX_STRING];
-            printf("Enter Name: ");
-            scanf(" %[^\n]", name);
-            toLowerCase(name);
-            
-            printf("\n%-8s %-25s %-30s %-8s\n", "ID", "Name", "Email", "Issued");
-            printf("────────────────────────────────────────────────────────────────\n");
-            
-            for (int i = 0; i < memberCount; i++) {
-                if (members[i].isActive) {
-                    char memberName[MAX_STRING];
-                    strcpy(memberName, members[i].name);
-                    toLowerCase(memberName);
-                    
-                    if (strstr(memberName, name) != NULL) {
-                        printf("%-8d %-25s %-30s %-8d\n",
-                               members[i].memberID, members[i].name,
-                               members[i].email, members[i].booksIssued);
-                        found = 1;
-                    }
-                }
-            }
-            break;
+        if (insert) {
+            bookFieldLength[slot][field] = (unsigned short)length;
+            fieldLengthTotal[field] += length;
         }
-        default:
-            printf("\n✗ Invalid choice!\n");
     }
-    
-    if (!found && (choice == 1 || choice == 2)) {
-        printf("\n✗ No members found!\n");
+    return count;
+}
+
+void indexBookText(int slot, int version) {
+    int termIDs[MAX_DOC_TERMS];
+    unsigned char tf[MAX_DOC_TERMS][TEXT_FIELD_COUNT];
+    int count = collectBookText(slot, 1, termIDs, tf);
+    
+    for (int i = 0; i < count && textPostingCount < MAX_TEXT_POSTINGS; i++) {
+        Term *term = &terms[termIDs[i]];
+        TextPosting *p = &textPostings[textPostingCount];
+        p->slot = slot;
+        p->version = version;
+        memcpy(p->tf, tf[i], TEXT_FIELD_COUNT);
+        p->next = term->textPostings;
+        term->textPostings = textPostingCount++;
+        term->documentFrequency++;
+        
+        float weight = 0;
+        for (int field = 0; field < TEXT_FIELD_COUNT; field++) {
+            weight += textFieldWeight[field] * tf[i][field];
+        }
+        if (weight > term->maxWeight) term->maxWeight = weight;
     }
+    textDocumentCount++;
+}
+
+void unindexBookTerms(int slot) {
+    int termIDs[MAX_DOC_TERMS];
+    unsigned char tf[MAX_DOC_TERMS][TEXT_FIELD_COUNT];
+    int count = collectBookText(slot, 0, termIDs, tf);
     
-    pauseScreen();
+    for (int i = 0; i < count; i++) {
+        terms[termIDs[i]].documentFrequency--;
+    }
+    for (int field = 0; field < TEXT_FIELD_COUNT; field++) {
+        fieldLengthTotal[field] -= bookFieldLength[slot][field];
+        bookFieldLength[slot][field] = 0;
+    }
+    textDocumentCount--;
+    bookTermVersion[slot]++;
+    termIndexDirty = 1;
+    suggestDirty = 1;
 }
 
-void updateMember() {
-    printHeader("UPDATE MEMBER");
+int selectTopText(const int *slots, int n, const float *scores, TextMatch *top, int k) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        int slot = slots[i];
+        int pos = count;
+        while (pos > 0 && (scores[slot] > top[pos - 1].score ||
+               (scores[slot] == top[pos - 1].score && books[slot].bookID < top[pos - 1].id))) {
+            if (pos < k) top[pos] = top[pos - 1];
+            pos--;
+        }
+        if (pos < k) {
+            top[pos].slot = slot;
+            top[pos].id = books[slot].bookID;
+            top[pos].score = scores[slot];
+            if (count < k) count++;
+        }
+    }
+    return count;
+}
+
+int fullTextSearch(const char *query, TextMatch *top, int k) {
+    static float score[MAX_BOOKS];
+    static int stamp[MAX_BOOKS], touched[MAX_BOOKS];
+    static int currentStamp = 0;
     
-    int id;
-    printf("Enter Member ID to update: ");
-    scanf("%d", &id);
+    int queryTerms[MAX_QUERY_TERMS];
+    float idf[MAX_QUERY_TERMS], bound[MAX_QUERY_TERMS], remaining[MAX_QUERY_TERMS + 1];
+    int count = 0;
+    char word[TERM_LENGTH];
     
-    int found = -1;
-    for (int i = 0; i < memberCount; i++) {
-        if (members[i].memberID == id && members[i].isActive) {
-            found = i;
-            break;
+    if (textDocumentCount <= 0 || k <= 0) return 0;
+    
+    while (count < MAX_QUERY_TERMS && nextTerm(&query, word) > 0) {
+        int t = findTerm(word, 0);
+        if (t == -1 || terms[t].documentFrequency <= 0) continue;
+        
+        int duplicate = 0;
+        for (int i = 0; i < count; i++) duplicate |= queryTerms[i] == t;
+        if (duplicate) continue;
+        
+        float df = (float)terms[t].documentFrequency;
+        float w = terms[t].maxWeight / (1 - BM25_B);
+        float termIdf = logf(1 + (textDocumentCount - df + 0.5f) / (df + 0.5f));
+        float termBound = termIdf * w / (BM25_K1 + w);
+        
+        int pos = count++;
+        while (pos > 0 && bound[pos - 1] < termBound) {
+            queryTerms[pos] = queryTerms[pos - 1];
+            idf[pos] = idf[pos - 1];
+            bound[pos] = bound[pos - 1];
+            pos--;
         }
+        queryTerms[pos] = t;
+        idf[pos] = termIdf;
+        bound[pos] = termBound;
     }
     
-    if (found == -1) {
-        printf("\n✗ Member not found!\n");
-        pauseScreen();
-        return;
+    remaining[count] = 0;
+    for (int i = count - 1; i >= 0; i--) {
+        remaining[i] = remaining[i + 1] + bound[i];
     }
     
-    printf("\nCurrent Details:\n");
-    printf("─────────────────\n");
-    printf("Name    : %s\n", members[found].name);
-    printf("Email   : %s\n", members[found].email);
-    printf("Phone   : %s\n", members[found].phone);
-    printf("Address : %s\n", members[found].address);
-    
-    printf("\nEnter New Details (press Enter to keep current):\n");
-    printf("─────────────────────────────────────────────────\n");
+    float averageLength[TEXT_FIELD_COUNT];
+    for (int field = 0; field < TEXT_FIELD_COUNT; field++) {
+        averageLength[field] = fieldLengthTotal[field] > 0
+            ? (float)fieldLengthTotal[field] / textDocumentCount : 1;
+    }
     
-    char input[MAX_STRING];
+    currentStamp++;
+    int touchedCount = 0, found = 0;
+    float threshold = 0;
     
-    printf("Name [%s]: ", members[found].name);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(members[found].name, input);
+    for (int i = 0; i < count; i++) {
+        int admit = found < k || threshold < remaining[i];
+        
+        for (int p = terms[queryTerms[i]].textPostings; p != -1; p = textPostings[p].next) {
+            TextPosting *posting = &textPostings[p];
+            int slot = posting->slot;
+            if (!books[slot].isActive || bookTermVersion[slot] != posting->version) continue;
+            
+            if (stamp[slot] != currentStamp) {
+                if (!admit) continue;
+                stamp[slot] = currentStamp;
+                score[slot] = 0;
+                touched[touchedCount++] = slot;
+            }
+            
+            float w = 0;
+            for (int field = 0; field < TEXT_FIELD_COUNT; field++) {
+                if (posting->tf[field] == 0) continue;
+                w += textFieldWeight[field] * posting->tf[field] /
+                     (1 - BM25_B + BM25_B * bookFieldLength[slot][field] / averageLength[field]);
+            }
+            score[slot] += idf[i] * w / (BM25_K1 + w);
+        }
+        
+        found = selectTopText(touched, touchedCount, score, top, k);
+        threshold = found == k ? top[k - 1].score : 0;
+    }
     
-    printf("Email [%s]: ", members[found].email);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(members[found].email, input);
+    return count > 0 ? found : 0;
+}
+
+void termIndexStamp(long long *stamp) {
+    unsigned int bookHash = 2166136261u, memberHash = 2166136261u;
+    memset(stamp, 0, TERM_STAMP_SIZE * sizeof(long long));
     
-    printf("Phone [%s]: ", members[found].phone);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(members[found].phone, input);
+    for (int i = 0; i < bookCount; i++) {
+        if (!books[i].isActive) continue;
+        bookHash = (bookHash ^ (unsigned int)i) * 16777619u;
+        for (int field = 0; field < TEXT_FIELD_COUNT; field++) {
+            const char *text = bookField(i, field);
+            bookHash = (bookHash ^ blockChecksum(text, strlen(text))) * 16777619u;
+        }
+    }
+    for (int i = 0; i < memberCount; i++) {
+        if (!members[i].isActive) continue;
+        memberHash = (memberHash ^ (unsigned int)i) * 16777619u;
+        memberHash = (memberHash ^ blockChecksum(members[i].name, strlen(members[i].name))) * 16777619u;
+    }
+    
+    stamp[0] = bookCount;
+    stamp[1] = bookHash;
+    stamp[2] = memberCount;
+    stamp[3] = memberHash;
+}
+
+void saveTermIndex() {
+    if (!termIndexDirty) {
+        return;
+    }
+    
+    long long stamp[TERM_STAMP_SIZE];
+    termIndexStamp(stamp);
+    
+    FILE *file = fopen(dataPath(FULLTEXT_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving search index!\n");
+        return;
+    }
+    
+    fwrite(stamp, sizeof(stamp), 1, file);
+    fwrite(&termCount, sizeof(int), 1, file);
+    fwrite(terms, sizeof(Term), termCount, file);
+    fwrite(termHashTable, sizeof(termHashTable), 1, file);
+    fwrite(&postingCount, sizeof(int), 1, file);
+    fwrite(postings, sizeof(Posting), postingCount, file);
+    fwrite(&textPostingCount, sizeof(int), 1, file);
+    fwrite(textPostings, sizeof(TextPosting), textPostingCount, file);
+    fwrite(bookTermVersion, sizeof(bookTermVersion), 1, file);
+    fwrite(memberTermVersion, sizeof(memberTermVersion), 1, file);
+    fwrite(bookFieldLength, sizeof(bookFieldLength), 1, file);
+    fwrite(fieldLengthTotal, sizeof(fieldLengthTotal), 1, file);
+    fwrite(&textDocumentCount, sizeof(int), 1, file);
+    fclose(file);
+    termIndexDirty = 0;
+}
+
+void loadTermIndex() {
+    FILE *file = fopen(dataPath(FULLTEXT_FILE), "rb");
+    if (file == NULL) {
+        rebuildTermIndex();
+        saveTermIndex();
+        return;
+    }
+    
+    long long stored[TERM_STAMP_SIZE], current[TERM_STAMP_SIZE];
+    termIndexStamp(current);
+    
+    int valid = fread(stored, sizeof(stored), 1, file) == 1 &&
+        memcmp(stored, current, sizeof(stored)) == 0 &&
+        fread(&termCount, sizeof(int), 1, file) == 1 && termCount >= 0 && termCount <= MAX_TERMS &&
+        fread(terms, sizeof(Term), termCount, file) == (size_t)termCount &&
+        fread(termHashTable, sizeof(termHashTable), 1, file) == 1 &&
+        fread(&postingCount, sizeof(int), 1, file) == 1 &&
+        postingCount >= 0 && postingCount <= MAX_POSTINGS &&
+        fread(postings, sizeof(Posting), postingCount, file) == (size_t)postingCount &&
+        fread(&textPostingCount, sizeof(int), 1, file) == 1 &&
+        textPostingCount >= 0 && textPostingCount <= MAX_TEXT_POSTINGS &&
+        fread(textPostings, sizeof(TextPosting), textPostingCount, file) == (size_t)textPostingCount &&
+        fread(bookTermVersion, sizeof(bookTermVersion), 1, file) == 1 &&
+        fread(memberTermVersion, sizeof(memberTermVersion), 1, file) == 1 &&
+        fread(bookFieldLength, sizeof(bookFieldLength), 1, file) == 1 &&
+        fread(fieldLengthTotal, sizeof(fieldLengthTotal), 1, file) == 1 &&
+        fread(&textDocumentCount, sizeof(int), 1, file) == 1;
+    fclose(file);
+    
+    if (!valid) {
+        rebuildTermIndex();
+        saveTermIndex();
+    }
+}
+
+int suggestionEntry(int kind, const char *text) {
+    unsigned int h = (hashFolded(text) + kind) & (SUGGEST_HASH_SIZE - 1);
+    while (suggestHashTable[h] != -1) {
+        Suggestion *entry = &suggestions[suggestHashTable[h]];
+        if (entry->kind == kind && compareFolded(entry->text, text) == 0) {
+            return suggestHashTable[h];
+        }
+        h = (h + 1) & (SUGGEST_HASH_SIZE - 1);
+    }
+    if (suggestionCount == MAX_SUGGESTIONS) return -1;
+    
+    int e = suggestionCount++;
+    suggestions[e].kind = kind;
+    suggestions[e].weight = 0;
+    strcpy(suggestions[e].text, text);
+    suggestHashTable[h] = e;
+    return e;
+}
+
+int trieChild(int node, char key, int insert) {
+    int child = trieNodes[node].child;
+    while (child != -1 && trieNodes[child].key != key) {
+        child = trieNodes[child].sibling;
+    }
+    if (child != -1 || !insert || trieNodeCount == MAX_TRIE_NODES) return child;
+    
+    child = trieNodeCount++;
+    trieNodes[child].key = key;
+    trieNodes[child].child = -1;
+    trieNodes[child].sibling = trieNodes[node].child;
+    trieNodes[child].topCount = 0;
+    trieNodes[node].child = child;
+    return child;
+}
+
+void trieOffer(int node, int entry) {
+    TrieNode *n = &trieNodes[node];
+    int pos = n->topCount;
+    while (pos > 0 && suggestions[n->top[pos - 1]].weight < suggestions[entry].weight) {
+        if (pos < SUGGEST_TOP_K) n->top[pos] = n->top[pos - 1];
+        pos--;
+    }
+    if (pos < SUGGEST_TOP_K) {
+        n->top[pos] = entry;
+        if (n->topCount < SUGGEST_TOP_K) n->topCount++;
+    }
+}
+
+void trieRaise(int node, int entry) {
+    TrieNode *n = &trieNodes[node];
+    int pos = 0;
+    while (pos < n->topCount && n->top[pos] != entry) pos++;
+    if (pos == n->topCount) {
+        trieOffer(node, entry);
+        return;
+    }
+    while (pos > 0 && suggestions[n->top[pos - 1]].weight < suggestions[entry].weight) {
+        n->top[pos] = n->top[pos - 1];
+        pos--;
+    }
+    n->top[pos] = entry;
+}
+
+void bumpSuggestion(int kind, const char *text) {
+    if (suggestDirty) return;
+    
+    int entry = suggestionEntry(kind, text);
+    if (entry == -1) return;
+    suggestions[entry].weight++;
+    
+    int node = suggestRoot[kind];
+    trieRaise(node, entry);
+    for (const char *p = text; *p && node != -1; p++) {
+        node = trieChild(node, (char)tolower((unsigned char)*p), 1);
+        if (node != -1) trieRaise(node, entry);
+    }
+}
+
+void rebuildSuggestions() {
+    suggestionCount = 0;
+    memset(suggestHashTable, -1, sizeof(suggestHashTable));
+    
+    for (int i = 0; i < bookCount; i++) {
+        if (!books[i].isActive) continue;
+        int title = suggestionEntry(SUGGEST_TITLE, books[i].title);
+        int author = suggestionEntry(SUGGEST_AUTHOR, books[i].author);
+        if (title != -1) suggestions[title].weight += analytics.bookBorrows[i];
+        if (author != -1) suggestions[author].weight += analytics.bookBorrows[i];
+    }
+    for (int i = 0; i < memberCount; i++) {
+        if (!members[i].isActive) continue;
+        int name = suggestionEntry(SUGGEST_MEMBER, members[i].name);
+        if (name != -1) suggestions[name].weight += analytics.memberBorrows[i];
+    }
+    
+    trieNodeCount = 0;
+    for (int kind = 0; kind < SUGGEST_KIND_COUNT; kind++) {
+        suggestRoot[kind] = trieNodeCount++;
+        trieNodes[suggestRoot[kind]].child = -1;
+        trieNodes[suggestRoot[kind]].sibling = -1;
+        trieNodes[suggestRoot[kind]].topCount = 0;
+    }
+    
+    for (int e = 0; e < suggestionCount; e++) {
+        int node = suggestRoot[suggestions[e].kind];
+        trieOffer(node, e);
+        for (const char *p = suggestions[e].text; *p && node != -1; p++) {
+            node = trieChild(node, (char)tolower((unsigned char)*p), 1);
+            if (node != -1) trieOffer(node, e);
+        }
+    }
+    suggestDirty = 0;
+}
+
+int readKey() {
+    #ifdef _WIN32
+        return _getch();
+    #else
+        return getchar();
+    #endif
+}
+
+void drawSuggestions(const char *prompt, const char *text, int node) {
+    int shown = 0;
+    printf("\r%s%s\033[J", prompt, text);
+    
+    if (node != -1 && text[0] != '\0') {
+        for (; shown < trieNodes[node].topCount; shown++) {
+            Suggestion *entry = &suggestions[trieNodes[node].top[shown]];
+            printf("\n    %-40s %d loan(s)", entry->text, entry->weight);
+        }
+    }
+    if (shown > 0) printf("\033[%dA", shown);
+    
+    int column = (int)(strlen(prompt) + strlen(text));
+    printf("\r");
+    if (column > 0) printf("\033[%dC", column);
+    fflush(stdout);
+}
+
+void readSuggested(const char *prompt, int kind, char *out) {
+    if (!isatty(fileno(stdin))) {
+        printf("%s", prompt);
+        scanf(" %[^\n]", out);
+        return;
+    }
+    if (suggestDirty) rebuildSuggestions();
+    
+    #ifndef _WIN32
+        struct termios saved, raw;
+        tcgetattr(fileno(stdin), &saved);
+        raw = saved;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(fileno(stdin), TCSANOW, &raw);
+    #endif
+    
+    int path[MAX_STRING];
+    int length = 0;
+    out[0] = '\0';
+    
+    while (1) {
+        int node = length > 0 ? path[length - 1] : suggestRoot[kind];
+        drawSuggestions(prompt, out, node);
+        
+        int c = readKey();
+        if (c == EOF || ((c == '\n' || c == '\r') && length > 0)) break;
+        
+        if (c == 127 || c == 8) {
+            if (length > 0) out[--length] = '\0';
+        } else if (c == '\t') {
+            if (node != -1 && trieNodes[node].topCount > 0) {
+                strcpy(out, suggestions[trieNodes[node].top[0]].text);
+                node = suggestRoot[kind];
+                for (length = 0; out[length]; length++) {
+                    node = node == -1 ? -1 : trieChild(node, (char)tolower((unsigned char)out[length]), 0);
+                    path[length] = node;
+                }
+            }
+        } else if (c == 27) {
+            #ifndef _WIN32
+                raw.c_cc[VMIN] = 0;
+                raw.c_cc[VTIME] = 1;
+                tcsetattr(fileno(stdin), TCSANOW, &raw);
+                
+                c = readKey();
+                if (c == '[' || c == 'O') {
+                    do {
+                        c = readKey();
+                    } while (c != EOF && (c < 0x40 || c > 0x7E));
+                }
+                clearerr(stdin);
+                
+                raw.c_cc[VMIN] = 1;
+                raw.c_cc[VTIME] = 0;
+                tcsetattr(fileno(stdin), TCSANOW, &raw);
+            #endif
+        } else if (isprint(c) && length < MAX_STRING - 1) {
+            path[length] = node == -1 ? -1 : trieChild(node, (char)tolower(c), 0);
+            out[length++] = (char)c;
+            out[length] = '\0';
+        }
+    }
+    
+    #ifndef _WIN32
+        tcsetattr(fileno(stdin), TCSANOW, &saved);
+    #endif
+    printf("\r\033[K%s%s\n\033[J", prompt, out);
+    ungetc('\n', stdin);
+}
+
+void renderBegin(FILE *out, int mode) {
+    fflush(stdout);
+    renderOut = out;
+    renderMode = mode;
+    renderLength = 0;
+}
+
+void renderFlush() {
+    if (renderLength > 0) {
+        fwrite(renderBuffer, 1, renderLength, renderOut ? renderOut : stdout);
+        renderLength = 0;
+    }
+}
+
+void renderf(const char *format, ...) {
+    if (RENDER_BUFFER_SIZE - renderLength < RENDER_LINE_MAX) {
+        renderFlush();
+    }
+    
+    va_list args;
+    va_start(args, format);
+    int room = RENDER_BUFFER_SIZE - renderLength;
+    int written = vsnprintf(renderBuffer + renderLength, room, format, args);
+    va_end(args);
+    
+    if (written >= room) {
+        renderFlush();
+        va_start(args, format);
+        vfprintf(renderOut ? renderOut : stdout, format, args);
+        va_end(args);
+    } else if (written > 0) {
+        renderLength += written;
+    }
+}
+
+void renderEnd() {
+    renderFlush();
+    fflush(renderOut ? renderOut : stdout);
+    renderMode = RENDER_TABLE;
+}
+
+void formatDate(time_t date, char *out) {
+    long day = (long)(date / SECONDS_PER_DAY);
+    DateCacheEntry *entry = &dateCache[(unsigned long)day % DATE_CACHE_SIZE];
+    
+    if (date < entry->dayStart || date >= entry->dayEnd) {
+        struct tm local = *localtime(&date);
+        strftime(entry->text, sizeof(entry->text), "%Y-%m-%d", &local);
+        
+        local.tm_hour = 0;
+        local.tm_min = 0;
+        local.tm_sec = 0;
+        local.tm_isdst = -1;
+        entry->dayStart = mktime(&local);
+        local.tm_mday++;
+        local.tm_isdst = -1;
+        entry->dayEnd = mktime(&local);
+    }
+    
+    memcpy(out, entry->text, sizeof(entry->text));
+}
+
+void addBook() {
+    printHeader("ADD NEW BOOK");
+    
+    if (bookCount >= MAX_BOOKS && freeBookCount == 0) {
+        printf("✗ Error: Maximum book limit reached!\n");
+        pauseScreen();
+        return;
+    }
+    
+    Book newBook;
+    newBook.bookID = generateBookID();
+    newBook.isActive = 1;
+    
+    printf("Enter Book Details:\n");
+    printf("─────────────────────\n\n");
+    
+    printf("Book ID (Auto-generated): %d\n", newBook.bookID);
+    
+    printf("Title: ");
+    scanf(" %[^\n]", newBook.title);
+    
+    printf("Author: ");
+    scanf(" %[^\n]", newBook.author);
+    
+    printf("ISBN: ");
+    scanf(" %[^\n]", newBook.ISBN);
+    
+    printf("Category: ");
+    scanf(" %[^\n]", newBook.category);
+    
+    printf("Total Copies: ");
+    scanf("%d", &newBook.totalCopies);
+    if (newBook.totalCopies < 1 || newBook.totalCopies > MAX_COPIES_PER_BOOK) {
+        printf("\n✗ Copies must be between 1 and %d!\n", MAX_COPIES_PER_BOOK);
+        pauseScreen();
+        return;
+    }
+    
+    newBook.availableCopies = newBook.totalCopies;
+    
+    printf("Price: Rs. ");
+    scanf("%f", &newBook.price);
+    
+    sharedBegin();
+    newBook.bookID = generateBookID();
+    int slot = allocateBookSlot();
+    if (slot == -1) {
+        printf("\n✗ Error: Maximum book limit reached!\n");
+        pauseScreen();
+        return;
+    }
+    
+    books[slot] = newBook;
+    indexBookSlot(slot);
+    classifyBook(slot);
+    reindexBook(slot);
+    btreeInsertBook(slot);
+    indexBookTerms(slot);
+    resetCopyRow(slot);
+    syncCopies(slot);
+    saveBooks();
+    saveCopies();
+    emitEvent(EVENT_BOOK_ADDED, newBook.bookID, 0, 0, newBook.price);
+    
+    printf("\n✓ Book added successfully with ID: %d\n", newBook.bookID);
+    pauseScreen();
+}
+
+int renderBooks(int order, const char *after, int limit, char *nextCursor) {
+    if (renderMode == RENDER_TSV) {
+        renderf("id\ttitle\tauthor\tisbn\tcategory\tavailable\ttotal\tprice\n");
+    } else {
+        renderf("%-8s %-30s %-25s %-15s %-8s\n", 
+                "ID", "Title", "Author", "ISBN", "Avail");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    int start = bookPageStart(order, after);
+    int end = bookOrderCount;
+    if (limit > 0 && start + limit < end) {
+        end = start + limit;
+    }
+    
+    for (int p = start; p < end; p++) {
+        int i = bookOrder[order][p];
+        
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%s\t%s\t%s\t%d\t%d\t%.2f\n",
+                    books[i].bookID, books[i].title, books[i].author,
+                    books[i].ISBN, books[i].category,
+                    books[i].availableCopies, books[i].totalCopies, books[i].price);
+        } else {
+            renderf("%-8d %-30s %-25s %-15s %d/%d\n",
+                    books[i].bookID,
+                    books[i].title,
+                    books[i].author,
+                    books[i].ISBN,
+                    books[i].availableCopies,
+                    books[i].totalCopies);
+        }
+    }
+    
+    if (nextCursor != NULL) {
+        nextCursor[0] = '\0';
+        if (end < bookOrderCount) {
+            int last = bookOrder[order][end - 1];
+            if (order == ORDER_BY_TITLE) {
+                snprintf(nextCursor, CURSOR_LENGTH, "%d:%s", books[last].bookID, books[last].title);
+            } else if (order == ORDER_BY_AUTHOR) {
+                snprintf(nextCursor, CURSOR_LENGTH, "%d:%s", books[last].bookID, books[last].author);
+            } else if (order == ORDER_BY_AVAILABILITY) {
+                snprintf(nextCursor, CURSOR_LENGTH, "%d:%d",
+                         books[last].bookID, books[last].availableCopies);
+            } else {
+                snprintf(nextCursor, CURSOR_LENGTH, "%d", books[last].bookID);
+            }
+        }
+    }
+    
+    return end - start;
+}
+
+void viewAllBooks() {
+    static const char *orderNames[BOOK_ORDER_COUNT] = {"ID", "Title", "Author", "Availability"};
+    char cursors[MAX_BOOKS / PAGE_SIZE + 2][CURSOR_LENGTH];
+    int page = 0;
+    int order = ORDER_BY_ID;
+    cursors[0][0] = '\0';
+    
+    while (1) {
+        printHeader("ALL BOOKS");
+        
+        if (bookOrderCount == 0) {
+            printf("No books available in the library.\n");
+            pauseScreen();
+            return;
+        }
+        
+        char nextCursor[CURSOR_LENGTH];
+        renderBegin(stdout, RENDER_TABLE);
+        int shown = renderBooks(order, cursors[page], PAGE_SIZE, nextCursor);
+        renderEnd();
+        
+        int firstRow = page * PAGE_SIZE + 1;
+        printf("\nShowing %d-%d of %d active books (ordered by %s)\n",
+               firstRow, firstRow + shown - 1, bookOrderCount, orderNames[order]);
+        printf("[N]ext  [P]revious  [O]rder  [Q]uit: ");
+        
+        char action;
+        scanf(" %c", &action);
+        action = tolower((unsigned char)action);
+        
+        if (action == 'n' && nextCursor[0] != '\0') {
+            strcpy(cursors[++page], nextCursor);
+        } else if (action == 'p' && page > 0) {
+            page--;
+        } else if (action == 'o') {
+            printf("Order by (1) ID (2) Title (3) Author (4) Availability: ");
+            int choice;
+            scanf("%d", &choice);
+            if (choice >= 1 && choice <= BOOK_ORDER_COUNT) {
+                order = choice - 1;
+                page = 0;
+            }
+        } else if (action == 'q') {
+            return;
+        }
+    }
+}
+
+void searchBook() {
+    printHeader("SEARCH BOOK");
+    
+    printf("Search By:\n");
+    printf("1. Book ID\n");
+    printf("2. Title\n");
+    printf("3. Author\n");
+    printf("4. ISBN\n");
+    printf("5. Advanced Query\n");
+    printf("6. Price Range\n");
+    printf("7. Title/Author Starts With\n");
+    printf("8. Keyword Search (ranked)\n");
+    printf("\nChoice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    
+    int found = 0;
+    int recommendedSlot = -1;
+    
+    switch (choice) {
+        case 1: {
+            int id;
+            printf("Enter Book ID: ");
+            scanf("%d", &id);
+            
+            for (int i = 0; i < bookCount; i++) {
+                if (books[i].bookID == id && books[i].isActive) {
+                    printf("\n✓ Book Found:\n");
+                    printf("─────────────────\n");
+                    printf("ID          : %d\n", books[i].bookID);
+                    printf("Title       : %s\n", books[i].title);
+                    printf("Author      : %s\n", books[i].author);
+                    printf("ISBN        : %s\n", books[i].ISBN);
+                    printf("Category    : %s\n", books[i].category);
+                    printf("Available   : %d/%d\n", 
+                           books[i].availableCopies, books[i].totalCopies);
+                    printf("Price       : Rs. %.2f\n", books[i].price);
+                    found = 1;
+                    recommendedSlot = i;
+                    break;
+                }
+            }
+            break;
+        }
+        case 2:
+        case 3: {
+            char text[MAX_STRING];
+            readSuggested(choice == 2 ? "Enter Title: " : "Enter Author: ",
+                          choice == 2 ? SUGGEST_TITLE : SUGGEST_AUTHOR, text);
+            
+            FuzzyMatch matches[MAX_BOOKS];
+            int count = fuzzySearch(choice == 2 ? TERM_TITLE : TERM_AUTHOR,
+                                    text, matches, MAX_BOOKS);
+            
+            printf("\n%-8s %-30s %-25s %-8s %s\n", "ID", "Title", "Author", "Avail", "Match");
+            printf("────────────────────────────────────────────────────────────────────────\n");
+            
+            for (int i = 0; i < count; i++) {
+                Book *book = &books[matches[i].slot];
+                char avail[16], match[16];
+                sprintf(avail, "%d/%d", book->availableCopies, book->totalCopies);
+                if (matches[i].contains) strcpy(match, "exact");
+                else if (matches[i].distance == 0) strcpy(match, "words");
+                else sprintf(match, "~%d", matches[i].distance);
+                
+                printf("%-8d %-30s %-25s %-8s %s\n",
+                       book->bookID, book->title, book->author, avail, match);
+            }
+            found = count > 0;
+            if (found) recommendedSlot = matches[0].slot;
+            break;
+        }
+        case 4: {
+            char isbn[20];
+            printf("Enter ISBN: ");
+            scanf(" %[^\n]", isbn);
+            
+            for (int i = 0; i < bookCount; i++) {
+                if (strcmp(books[i].ISBN, isbn) == 0 && books[i].isActive) {
+                    printf("\n✓ Book Found:\n");
+                    printf("─────────────────\n");
+                    printf("ID          : %d\n", books[i].bookID);
+                    printf("Title       : %s\n", books[i].title);
+                    printf("Author      : %s\n", books[i].author);
+                    printf("ISBN        : %s\n", books[i].ISBN);
+                    printf("Available   : %d/%d\n", 
+                           books[i].availableCopies, books[i].totalCopies);
+                    found = 1;
+                    recommendedSlot = i;
+                    break;
+                }
+            }
+            break;
+        }
+        case 5:
+            advancedQuery();
+            found = 1;
+            break;
+        case 8: {
+            char keywords[MAX_STRING * 2];
+            printf("Keywords: ");
+            scanf(" %[^\n]", keywords);
+            printf("\n");
+            
+            renderBegin(stdout, RENDER_TABLE);
+            found = renderSearch(keywords, FULLTEXT_TOP_K) > 0;
+            renderEnd();
+            break;
+        }
+        case 6:
+        case 7: {
+            char query[MAX_STRING * 2];
+            if (choice == 6) {
+                float low, high;
+                printf("Minimum Price: Rs. ");
+                scanf("%f", &low);
+                printf("Maximum Price: Rs. ");
+                scanf("%f", &high);
+                sprintf(query, "price >= %.2f AND price <= %.2f", low, high);
+            } else {
+                char prefix[MAX_STRING];
+                int field;
+                printf("Match (1) Title (2) Author: ");
+                scanf("%d", &field);
+                printf("Starts With: ");
+                scanf(" %[^\n]", prefix);
+                sprintf(query, "%s ^ \"%s\"", field == 2 ? "author" : "title", prefix);
+            }
+            printf("\n");
+            
+            renderBegin(stdout, RENDER_TABLE);
+            int matched = renderQuery(query);
+            renderEnd();
+            
+            found = matched > 0;
+            break;
+        }
+        default:
+            printf("\n✗ Invalid choice!\n");
+    }
+    
+    if (!found && choice >= 1 && choice <= 8 && choice != 5) {
+        printf("\n✗ No books found!\n");
+    }
+    
+    if (recommendedSlot != -1) {
+        printf("\n");
+        renderBegin(stdout, RENDER_TABLE);
+        renderRecommendations(recommendedSlot, -1, RECOMMEND_SHOWN);
+        renderEnd();
+    }
+    
+    pauseScreen();
+}
+
+int containsFolded(const char *haystack, const char *needle) {
+    if (needle[0] == '\0') {
+        return 1;
+    }
+    
+    for (; *haystack; haystack++) {
+        int i = 0;
+        while (needle[i] && haystack[i] &&
+               tolower((unsigned char)haystack[i]) == (unsigned char)needle[i]) {
+            i++;
+        }
+        if (needle[i] == '\0') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int parseQuery(const char *text, QueryPlan *plan, char *error) {
+    static const char *fieldNames[] = {
+        "id", "title", "author", "category", "isbn", "total", "available", "price"
+    };
+    const char *p = text;
+    plan->count = 0;
+    
+    while (1) {
+        while (isspace((unsigned char)*p)) p++;
+        
+        if (plan->count >= MAX_PREDICATES) {
+            sprintf(error, "Too many conditions (max %d)", MAX_PREDICATES);
+            return 0;
+        }
+        Predicate *pred = &plan->predicates[plan->count];
+        
+        char name[MAX_STRING];
+        int length = 0;
+        while (isalpha((unsigned char)*p) && length < MAX_STRING - 1) {
+            name[length++] = tolower((unsigned char)*p++);
+        }
+        name[length] = '\0';
+        
+        pred->field = -1;
+        for (int f = 0; f <= FIELD_PRICE; f++) {
+            if (strcmp(name, fieldNames[f]) == 0) {
+                pred->field = f;
+            }
+        }
+        if (pred->field == -1) {
+            sprintf(error, "Unknown field '%s'", name);
+            return 0;
+        }
+        
+        while (isspace((unsigned char)*p)) p++;
+        if (strncmp(p, "!=", 2) == 0) { pred->op = OP_NE; p += 2; }
+        else if (strncmp(p, "<=", 2) == 0) { pred->op = OP_LE; p += 2; }
+        else if (strncmp(p, ">=", 2) == 0) { pred->op = OP_GE; p += 2; }
+        else if (*p == '<') { pred->op = OP_LT; p++; }
+        else if (*p == '>') { pred->op = OP_GT; p++; }
+        else if (*p == '=') { pred->op = OP_EQ; p++; }
+        else if (*p == '~') { pred->op = OP_CONTAINS; p++; }
+        else if (*p == '^') { pred->op = OP_PREFIX; p++; }
+        else {
+            sprintf(error, "Expected an operator after '%s'", name);
+            return 0;
+        }
+        
+        while (isspace((unsigned char)*p)) p++;
+        length = 0;
+        if (*p == '"') {
+            p++;
+            while (*p && *p != '"' && length < MAX_STRING - 1) {
+                pred->text[length++] = tolower((unsigned char)*p++);
+            }
+            if (*p != '"') {
+                sprintf(error, "Unterminated string");
+                return 0;
+            }
+            p++;
+        } else {
+            while (*p && !isspace((unsigned char)*p) && length < MAX_STRING - 1) {
+                pred->text[length++] = tolower((unsigned char)*p++);
+            }
+        }
+        pred->text[length] = '\0';
+        pred->number = (float)atof(pred->text);
+        
+        int numeric = pred->field == FIELD_ID || pred->field >= FIELD_TOTAL;
+        if (length == 0) {
+            sprintf(error, "Missing value for '%s'", name);
+            return 0;
+        }
+        if (numeric && pred->op >= OP_CONTAINS) {
+            sprintf(error, "'~' and '^' only apply to text fields");
+            return 0;
+        }
+        if (!numeric && pred->op >= OP_LT && pred->op <= OP_GE) {
+            sprintf(error, "Text fields support =, !=, ~ and ^ only");
+            return 0;
+        }
+        plan->count++;
+        
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0') {
+            return 1;
+        }
+        if (tolower((unsigned char)p[0]) != 'a' || tolower((unsigned char)p[1]) != 'n' ||
+            tolower((unsigned char)p[2]) != 'd' || !isspace((unsigned char)p[3])) {
+            sprintf(error, "Expected AND near '%s'", p);
+            return 0;
+        }
+        p += 3;
+    }
+}
+
+int compareProbe(int order, int slot, const char *text, float number) {
+    if (order == ORDER_BY_TITLE) {
+        return compareFolded(books[slot].title, text);
+    }
+    if (order == ORDER_BY_AUTHOR) {
+        return compareFolded(books[slot].author, text);
+    }
+    if (order == ORDER_BY_AVAILABILITY) {
+        return (number > books[slot].availableCopies) - (number < books[slot].availableCopies);
+    }
+    return (books[slot].bookID > number) - (books[slot].bookID < number);
+}
+
+int orderBound(int order, const char *text, float number, int upper) {
+    int lo = 0, hi = bookOrderCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = compareProbe(order, bookOrder[order][mid], text, number);
+        if (cmp < 0 || (upper && cmp == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void planQuery(QueryPlan *plan) {
+    plan->indexOrder = -1;
+    plan->tree = -1;
+    plan->prefixPredicate = -1;
+    plan->lookup = 0;
+    plan->lookupSlot = -1;
+    plan->rangeStart = 0;
+    plan->rangeEnd = bookOrderCount;
+    int best = bookOrderCount + 1;
+    
+    for (int i = 0; i < plan->count; i++) {
+        Predicate *pred = &plan->predicates[i];
+        int order = -1;
+        
+        if (pred->field == FIELD_ID && pred->op == OP_EQ) {
+            int slot = findBookSlot((int)pred->number);
+            plan->indexOrder = -1;
+            plan->lookup = 1;
+            plan->lookupSlot = slot;
+            plan->rangeStart = 0;
+            plan->rangeEnd = slot != -1;
+            return;
+        }
+        
+        if (pred->field == FIELD_ID) order = ORDER_BY_ID;
+        if (pred->field == FIELD_TITLE && pred->op == OP_EQ) order = ORDER_BY_TITLE;
+        if (pred->field == FIELD_AUTHOR && pred->op == OP_EQ) order = ORDER_BY_AUTHOR;
+        if (pred->field == FIELD_AVAILABLE) order = ORDER_BY_AVAILABILITY;
+        if (order == -1 || pred->op == OP_NE) continue;
+        
+        int lower = orderBound(order, pred->text, pred->number, 0);
+        int upper = orderBound(order, pred->text, pred->number, 1);
+        int start = 0, end = bookOrderCount;
+        int before = order == ORDER_BY_AVAILABILITY;
+        
+        if (pred->op == OP_EQ) { start = lower; end = upper; }
+        else if (pred->op == OP_LT) { if (before) start = upper; else end = lower; }
+        else if (pred->op == OP_LE) { if (before) start = lower; else end = upper; }
+        else if (pred->op == OP_GT) { if (before) end = lower; else start = upper; }
+        else if (pred->op == OP_GE) { if (before) end = upper; else start = lower; }
+        
+        if (end - start < best) {
+            best = end - start;
+            plan->indexOrder = order;
+            plan->rangeStart = start;
+            plan->rangeEnd = end;
+        }
+    }
+    
+    plan->priceLow = -1e30f;
+    plan->priceHigh = 1e30f;
+    plan->priceLowStrict = 0;
+    plan->priceHighStrict = 0;
+    int priceBounded = 0;
+    
+    for (int i = 0; i < plan->count; i++) {
+        Predicate *pred = &plan->predicates[i];
+        if (pred->field != FIELD_PRICE || pred->op == OP_NE) continue;
+        
+        float v = pred->number;
+        if (pred->op != OP_LT && pred->op != OP_LE &&
+            (v > plan->priceLow || (v == plan->priceLow && pred->op == OP_GT))) {
+            plan->priceLow = v;
+            plan->priceLowStrict = pred->op == OP_GT;
+        }
+        if (pred->op != OP_GT && pred->op != OP_GE &&
+            (v < plan->priceHigh || (v == plan->priceHigh && pred->op == OP_LT))) {
+            plan->priceHigh = v;
+            plan->priceHighStrict = pred->op == OP_LT;
+        }
+        priceBounded = 1;
+    }
+    
+    for (int i = -1; i < plan->count; i++) {
+        int tree = -1;
+        if (i == -1 && priceBounded) {
+            tree = BTREE_PRICE;
+        } else if (i >= 0 && plan->predicates[i].op == OP_PREFIX) {
+            tree = plan->predicates[i].field == FIELD_TITLE ? BTREE_TITLE
+                 : plan->predicates[i].field == FIELD_AUTHOR ? BTREE_AUTHOR : -1;
+        }
+        if (tree == -1) continue;
+        
+        int previousTree = plan->tree, previousPrefix = plan->prefixPredicate;
+        plan->tree = tree;
+        plan->prefixPredicate = i;
+        
+        BTreeCursor cursor = planTreeStart(plan);
+        unsigned long long prefix;
+        int candidates = 0;
+        while (candidates < best && btreeNext(tree, &cursor, &prefix) != -1 &&
+               planTreeInRange(plan, prefix)) {
+            candidates++;
+        }
+        
+        if (candidates < best) {
+            best = candidates;
+            plan->treeCandidates = candidates;
+            plan->indexOrder = -1;
+        } else {
+            plan->tree = previousTree;
+            plan->prefixPredicate = previousPrefix;
+        }
+    }
+    
+    if (plan->tree == -1 && plan->indexOrder != -1 && best == bookOrderCount) {
+        plan->indexOrder = -1;
+    }
+}
+
+BTreeCursor planTreeStart(const QueryPlan *plan) {
+    if (plan->tree == BTREE_PRICE) {
+        if (plan->priceLow <= -1e30f) {
+            return btreeSeek(BTREE_PRICE, 0, INT_MIN);
+        }
+        return btreeSeek(BTREE_PRICE, priceKey(plan->priceLow),
+                         plan->priceLowStrict ? INT_MAX : INT_MIN);
+    }
+    
+    return btreeSeek(plan->tree, foldedPrefix(plan->predicates[plan->prefixPredicate].text),
+                     INT_MIN);
+}
+
+int planTreeInRange(const QueryPlan *plan, unsigned long long prefix) {
+    if (plan->tree == BTREE_PRICE) {
+        unsigned long long high = priceKey(plan->priceHigh);
+        return plan->priceHighStrict ? prefix < high : prefix <= high;
+    }
+    return prefix <= foldedPrefixEnd(plan->predicates[plan->prefixPredicate].text);
+}
+
+int filterBatch(const QueryPlan *plan, const int *candidates, int n, int *selected) {
+    int total[SCAN_BATCH], available[SCAN_BATCH], id[SCAN_BATCH];
+    float price[SCAN_BATCH];
+    int count = 0;
+    
+    for (int j = 0; j < n; j++) {
+        int slot = candidates[j];
+        id[j] = books[slot].bookID;
+        total[j] = books[slot].totalCopies;
+        available[j] = books[slot].availableCopies;
+        price[j] = books[slot].price;
+        selected[count] = j;
+        count += books[slot].isActive != 0;
+    }
+    
+    for (int i = 0; i < plan->count && count > 0; i++) {
+        const Predicate *pred = &plan->predicates[i];
+        int kept = 0;
+        
+        if (pred->field == FIELD_ID || pred->field >= FIELD_TOTAL) {
+            float v = pred->number;
+            float column[SCAN_BATCH];
+            for (int j = 0; j < n; j++) {
+                column[j] = pred->field == FIELD_PRICE ? price[j]
+                          : pred->field == FIELD_AVAILABLE ? (float)available[j]
+                          : pred->field == FIELD_TOTAL ? (float)total[j] : (float)id[j];
+            }
+            
+            switch (pred->op) {
+                case OP_EQ:
+                    for (int j = 0; j < count; j++) {
+                        selected[kept] = selected[j];
+                        kept += column[selected[j]] == v;
+                    }
+                    break;
+                case OP_NE:
+                    for (int j = 0; j < count; j++) {
+                        selected[kept] = selected[j];
+                        kept += column[selected[j]] != v;
+                    }
+                    break;
+                case OP_LT:
+                    for (int j = 0; j < count; j++) {
+                        selected[kept] = selected[j];
+                        kept += column[selected[j]] < v;
+                    }
+                    break;
+                case OP_LE:
+                    for (int j = 0; j < count; j++) {
+                        selected[kept] = selected[j];
+                        kept += column[selected[j]] <= v;
+                    }
+                    break;
+                case OP_GT:
+                    for (int j = 0; j < count; j++) {
+                        selected[kept] = selected[j];
+                        kept += column[selected[j]] > v;
+                    }
+                    break;
+                case OP_GE:
+                    for (int j = 0; j < count; j++) {
+                        selected[kept] = selected[j];
+                        kept += column[selected[j]] >= v;
+                    }
+                    break;
+            }
+        } else {
+            for (int j = 0; j < count; j++) {
+                int slot = candidates[selected[j]];
+                const char *value = pred->field == FIELD_TITLE ? books[slot].title
+                                  : pred->field == FIELD_AUTHOR ? books[slot].author
+                                  : pred->field == FIELD_CATEGORY ? books[slot].category
+                                  : books[slot].ISBN;
+                int match = pred->op == OP_CONTAINS ? containsFolded(value, pred->text)
+                          : pred->op == OP_PREFIX ? startsWithFolded(value, pred->text)
+                          : compareFolded(value, pred->text) == 0;
+                if (pred->op == OP_NE) match = !match;
+                selected[kept] = selected[j];
+                kept += match;
+            }
+        }
+        count = kept;
+    }
+    
+    for (int j = 0; j < count; j++) {
+        selected[j] = candidates[selected[j]];
+    }
+    return count;
+}
+
+int executeQuery(QueryPlan *plan, int *results, int maxResults) {
+    int candidates[SCAN_BATCH], selected[SCAN_BATCH];
+    int found = 0;
+    
+    planQuery(plan);
+    
+    if (plan->lookup) {
+        if (plan->lookupSlot == -1) return 0;
+        candidates[0] = plan->lookupSlot;
+        int n = filterBatch(plan, candidates, 1, selected);
+        if (n > 0 && maxResults > 0) results[found++] = selected[0];
+        return found;
+    }
+    
+    if (plan->tree != -1) {
+        BTreeCursor cursor = planTreeStart(plan);
+        unsigned long long prefix;
+        int n = 0, slot = 0;
+        
+        while (found < maxResults && slot != -1) {
+            slot = btreeNext(plan->tree, &cursor, &prefix);
+            if (slot != -1 && !planTreeInRange(plan, prefix)) {
+                slot = -1;
+            }
+            if (slot != -1) {
+                candidates[n++] = slot;
+            }
+            
+            if (n == SCAN_BATCH || (slot == -1 && n > 0)) {
+                int matched = filterBatch(plan, candidates, n, selected);
+                for (int j = 0; j < matched && found < maxResults; j++) {
+                    results[found++] = selected[j];
+                }
+                n = 0;
+            }
+        }
+        return found;
+    }
+    
+    int start = plan->indexOrder != -1 ? plan->rangeStart : 0;
+    int end = plan->indexOrder != -1 ? plan->rangeEnd : bookCount;
+    
+    for (int base = start; base < end && found < maxResults; base += SCAN_BATCH) {
+        int n = end - base < SCAN_BATCH ? end - base : SCAN_BATCH;
+        for (int j = 0; j < n; j++) {
+            candidates[j] = plan->indexOrder != -1 ? bookOrder[plan->indexOrder][base + j]
+                                                   : base + j;
+        }
+        
+        int matched = filterBatch(plan, candidates, n, selected);
+        for (int j = 0; j < matched && found < maxResults; j++) {
+            results[found++] = selected[j];
+        }
+    }
+    
+    return found;
+}
+
+int renderQuery(const char *text) {
+    static const char *orderNames[BOOK_ORDER_COUNT] = {"id", "title", "author", "availability"};
+    static int results[MAX_BOOKS];
+    QueryPlan plan;
+    char error[MAX_STRING * 2];
+    
+    if (!parseQuery(text, &plan, error)) {
+        renderf("✗ Query error: %s\n", error);
+        return -1;
+    }
+    
+    int found = executeQuery(&plan, results, MAX_BOOKS);
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("id\ttitle\tauthor\tcategory\tavailable\ttotal\tprice\n");
+    } else {
+        if (plan.lookup) {
+            renderf("Plan: ID lookup\n\n");
+        } else if (plan.tree != -1) {
+            static const char *treeNames[BTREE_COUNT] = {"price", "title", "author"};
+            renderf("Plan: %s B+tree (%d candidates)\n\n", treeNames[plan.tree],
+                    plan.treeCandidates);
+        } else if (plan.indexOrder != -1) {
+            renderf("Plan: %s index (%d candidates)\n\n", orderNames[plan.indexOrder],
+                    plan.rangeEnd - plan.rangeStart);
+        } else {
+            renderf("Plan: column scan (%d rows)\n\n", bookCount);
+        }
+        renderf("%-8s %-30s %-20s %-15s %-8s %-10s\n",
+                "ID", "Title", "Author", "Category", "Avail", "Price");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < found; i++) {
+        Book *book = &books[results[i]];
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%s\t%s\t%d\t%d\t%.2f\n", book->bookID, book->title,
+                    book->author, book->category, book->availableCopies,
+                    book->totalCopies, book->price);
+        } else {
+            renderf("%-8d %-30s %-20s %-15s %d/%-6d %.2f\n", book->bookID, book->title,
+                    book->author, book->category, book->availableCopies,
+                    book->totalCopies, book->price);
+        }
+    }
+    
+    return found;
+}
+
+void advancedQuery() {
+    printf("\nFields : id, title, author, category, isbn, total, available, price\n");
+    printf("Ops    : =  !=  <  <=  >  >=  ~ (contains)  ^ (starts with)\n");
+    printf("Example: category = \"Fiction\" AND available > 0 AND price < 500\n");
+    printf("\nQuery: ");
+    
+    char query[MAX_STRING * 4];
+    scanf(" %[^\n]", query);
+    printf("\n");
+    
+    renderBegin(stdout, RENDER_TABLE);
+    int found = renderQuery(query);
+    renderEnd();
+    
+    if (found >= 0) {
+        printf("\n%d book(s) matched.\n", found);
+    }
+}
+
+int renderSearch(const char *text, int limit) {
+    static TextMatch top[MAX_BOOKS];
+    int found = fullTextSearch(text, top, limit > 0 && limit < MAX_BOOKS ? limit : FULLTEXT_TOP_K);
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("id\ttitle\tauthor\tcategory\tavailable\ttotal\tscore\n");
+    } else {
+        renderf("%-8s %-30s %-20s %-15s %-8s %-6s\n",
+                "ID", "Title", "Author", "Category", "Avail", "Score");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < found; i++) {
+        Book *book = &books[top[i].slot];
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%s\t%s\t%d\t%d\t%.3f\n", book->bookID, book->title,
+                    book->author, book->category, book->availableCopies,
+                    book->totalCopies, top[i].score);
+        } else {
+            renderf("%-8d %-30s %-20s %-15s %d/%-6d %.2f\n", book->bookID, book->title,
+                    book->author, book->category, book->availableCopies,
+                    book->totalCopies, top[i].score);
+        }
+    }
+    
+    return found;
+}
+
+void updateBook() {
+    printHeader("UPDATE BOOK");
+    
+    int id;
+    printf("Enter Book ID to update: ");
+    scanf("%d", &id);
+    
+    int found = -1;
+    for (int i = 0; i < bookCount; i++) {
+        if (books[i].bookID == id && books[i].isActive) {
+            found = i;
+            break;
+        }
+    }
+    
+    if (found == -1) {
+        printf("\n✗ Book not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\nCurrent Details:\n");
+    printf("─────────────────\n");
+    printf("Title       : %s\n", books[found].title);
+    printf("Author      : %s\n", books[found].author);
+    printf("ISBN        : %s\n", books[found].ISBN);
+    printf("Category    : %s\n", books[found].category);
+    printf("Total Copies: %d\n", books[found].totalCopies);
+    printf("Price       : Rs. %.2f\n", books[found].price);
+    
+    printf("\nEnter New Details (press Enter to keep current):\n");
+    printf("─────────────────────────────────────────────────\n");
+    
+    char title[MAX_STRING], author[MAX_STRING], category[MAX_STRING], price[MAX_STRING];
+    
+    printf("Title [%s]: ", books[found].title);
+    scanf(" %[^\n]", title);
+    
+    printf("Author [%s]: ", books[found].author);
+    scanf(" %[^\n]", author);
+    
+    printf("Category [%s]: ", books[found].category);
+    scanf(" %[^\n]", category);
+    
+    printf("Price [%.2f]: ", books[found].price);
+    scanf(" %[^\n]", price);
+    
+    sharedBegin();
+    found = findBookSlot(id);
+    if (found == -1 || !books[found].isActive) {
+        printf("\n✗ Book was removed by another desk!\n");
+        pauseScreen();
+        return;
+    }
+    
+    btreeRemoveBook(found);
+    unindexBookTerms(found);
+    if (strlen(title) > 0) strcpy(books[found].title, title);
+    if (strlen(author) > 0) strcpy(books[found].author, author);
+    if (strlen(category) > 0) strcpy(books[found].category, category);
+    if (strlen(price) > 0) books[found].price = atof(price);
+    
+    reindexBook(found);
+    classifyBook(found);
+    btreeInsertBook(found);
+    indexBookTerms(found);
+    saveBooks();
+    emitEvent(EVENT_BOOK_UPDATED, books[found].bookID, 0, 0, books[found].price);
+    printf("\n✓ Book updated successfully!\n");
+    pauseScreen();
+}
+
+void deleteBook() {
+    printHeader("DELETE BOOK");
+    
+    int id;
+    printf("Enter Book ID to delete: ");
+    scanf("%d", &id);
+    
+    int found = -1;
+    for (int i = 0; i < bookCount; i++) {
+        if (books[i].bookID == id && books[i].isActive) {
+            found = i;
+            break;
+        }
+    }
+    
+    if (found == -1) {
+        printf("\n✗ Book not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    int onLoan = 0;
+    for (int c = 0; c < copyRows[found].count; c++) {
+        if (copyRows[found].items[c].status == COPY_ON_LOAN) onLoan++;
+    }
+    
+    printf("\nBook: %s by %s\n", books[found].title, books[found].author);
+    if (onLoan > 0) {
+        printf("%d copy(ies) on loan will be withdrawn as they are returned.\n", onLoan);
+    }
+    printf("Are you sure you want to delete? (y/n): ");
+    
+    char confirm;
+    scanf(" %c", &confirm);
+    
+    if (confirm == 'y' || confirm == 'Y') {
+        sharedBegin();
+        found = findBookSlot(id);
+        if (found == -1 || !books[found].isActive) {
+            printf("\n✗ Book was removed by another desk!\n");
+            pauseScreen();
+            return;
+        }
+        onLoan = 0;
+        for (int c = 0; c < copyRows[found].count; c++) {
+            if (copyRows[found].items[c].status == COPY_ON_LOAN) onLoan++;
+        }
+        
+        btreeRemoveBook(found);
+        unindexBookTerms(found);
+        books[found].isActive = 0;
+        reindexBook(found);
+        cancelBookHolds(found, libraryNow());
+        for (int c = 0; c < copyRows[found].count; c++) {
+            int status = copyRows[found].items[c].status;
+            if (status == COPY_AVAILABLE || status == COPY_RESERVED) {
+                setCopyStatus(found, c, COPY_WITHDRAWN);
+            }
+        }
+        books[found].totalCopies = onLoan;
+        books[found].availableCopies = 0;
+        freeBookSlots[freeBookCount++] = found;
+        saveHolds();
+        saveBooks();
+        saveCopies();
+        emitEvent(EVENT_BOOK_DELETED, books[found].bookID, 0, 0, 0);
+        printf("\n✓ Book deleted successfully!\n");
+        compactIfSparse();
+    } else {
+        printf("\n✓ Deletion cancelled.\n");
+    }
+    
+    pauseScreen();
+}
+
+void bookManagementMenu() {
+    while (1) {
+        printHeader("BOOK MANAGEMENT");
+        
+        printf("1. Add New Book\n");
+        printf("2. View All Books\n");
+        printf("3. Search Book\n");
+        printf("4. Update Book\n");
+        printf("5. Delete Book\n");
+        printf("6. Manage Copies\n");
+        printf("7. Back to Main Menu\n");
+        printf("\nChoice: ");
+        
+        int choice;
+        scanf("%d", &choice);
+        
+        switch (choice) {
+            case 1: addBook(); break;
+            case 2: viewAllBooks(); break;
+            case 3: searchBook(); break;
+            case 4: updateBook(); break;
+            case 5: deleteBook(); break;
+            case 6: manageCopies(); break;
+            case 7: return;
+            default:
+                printf("\n✗ Invalid choice!\n");
+                pauseScreen();
+        }
+    }
+}
+
+void addMember() {
+    printHeader("ADD NEW MEMBER");
+    
+    if (memberCount >= MAX_MEMBERS && freeMemberCount == 0) {
+        printf("✗ Error: Maximum member limit reached!\n");
+        pauseScreen();
+        return;
+    }
+    
+    Member newMember;
+    newMember.memberID = generateMemberID();
+    newMember.booksIssued = 0;
+    newMember.totalFines = 0.0;
+    newMember.isActive = 1;
+    
+    printf("Enter Member Details:\n");
+    printf("─────────────────────\n\n");
+    
+    printf("Member ID (Auto-generated): %d\n", newMember.memberID);
+    
+    printf("Name: ");
+    scanf(" %[^\n]", newMember.name);
+    
+    printf("Email: ");
+    scanf(" %[^\n]", newMember.email);
+    
+    printf("Phone: ");
+    scanf(" %[^\n]", newMember.phone);
+    
+    printf("Address: ");
+    scanf(" %[^\n]", newMember.address);
+    
+    char tier[MAX_STRING];
+    printf("Tier (1 Student, 2 Faculty, 3 Staff): ");
+    scanf(" %[^\n]", tier);
+    newMember.tier = parseTier(tier);
+    if (newMember.tier == -1) newMember.tier = TIER_STUDENT;
+    
+    sharedBegin();
+    newMember.memberID = generateMemberID();
+    int slot = allocateMemberSlot();
+    if (slot == -1) {
+        printf("\n✗ Error: Maximum member limit reached!\n");
+        pauseScreen();
+        return;
+    }
+    
+    members[slot] = newMember;
+    indexMemberSlot(slot);
+    reindexMember(slot);
+    indexMemberTerms(slot);
+    saveMembers();
+    emitEvent(EVENT_MEMBER_ADDED, 0, newMember.memberID, 0, 0);
+    
+    printf("\n✓ Member registered successfully with ID: %d\n", newMember.memberID);
+    pauseScreen();
+}
+
+int renderMembers(int order, const char *after, int limit, char *nextCursor) {
+    if (renderMode == RENDER_TSV) {
+        renderf("id\tname\temail\tphone\tissued\tfines\ttier\n");
+    } else {
+        renderf("%-8s %-25s %-30s %-15s %-8s\n", 
+                "ID", "Name", "Email", "Phone", "Issued");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    int start = memberPageStart(order, after);
+    int end = memberOrderCount;
+    if (limit > 0 && start + limit < end) {
+        end = start + limit;
+    }
+    
+    for (int p = start; p < end; p++) {
+        int i = memberOrder[order][p];
+        
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%s\t%s\t%d\t%.2f\t%s\n",
+                    members[i].memberID, members[i].name, members[i].email,
+                    members[i].phone, members[i].booksIssued, members[i].totalFines,
+                    tierNames[members[i].tier]);
+        } else {
+            renderf("%-8d %-25s %-30s %-15s %-8d\n",
+                    members[i].memberID,
+                    members[i].name,
+                    members[i].email,
+                    members[i].phone,
+                    members[i].booksIssued);
+        }
+    }
+    
+    if (nextCursor != NULL) {
+        nextCursor[0] = '\0';
+        if (end < memberOrderCount) {
+            int last = memberOrder[order][end - 1];
+            if (order == ORDER_BY_NAME) {
+                snprintf(nextCursor, CURSOR_LENGTH, "%d:%s", members[last].memberID, members[last].name);
+            } else {
+                snprintf(nextCursor, CURSOR_LENGTH, "%d", members[last].memberID);
+            }
+        }
+    }
+    
+    return end - start;
+}
+
+void viewAllMembers() {
+    static const char *orderNames[MEMBER_ORDER_COUNT] = {"ID", "Name"};
+    char cursors[MAX_MEMBERS / PAGE_SIZE + 2][CURSOR_LENGTH];
+    int page = 0;
+    int order = ORDER_BY_ID;
+    cursors[0][0] = '\0';
+    
+    while (1) {
+        printHeader("ALL MEMBERS");
+        
+        if (memberOrderCount == 0) {
+            printf("No members registered.\n");
+            pauseScreen();
+            return;
+        }
+        
+        char nextCursor[CURSOR_LENGTH];
+        renderBegin(stdout, RENDER_TABLE);
+        int shown = renderMembers(order, cursors[page], PAGE_SIZE, nextCursor);
+        renderEnd();
+        
+        int firstRow = page * PAGE_SIZE + 1;
+        printf("\nShowing %d-%d of %d active members (ordered by %s)\n",
+               firstRow, firstRow + shown - 1, memberOrderCount, orderNames[order]);
+        printf("[N]ext  [P]revious  [O]rder  [Q]uit: ");
+        
+        char action;
+        scanf(" %c", &action);
+        action = tolower((unsigned char)action);
+        
+        if (action == 'n' && nextCursor[0] != '\0') {
+            strcpy(cursors[++page], nextCursor);
+        } else if (action == 'p' && page > 0) {
+            page--;
+        } else if (action == 'o') {
+            printf("Order by (1) ID (2) Name: ");
+            int choice;
+            scanf("%d", &choice);
+            if (choice >= 1 && choice <= MEMBER_ORDER_COUNT) {
+                order = choice - 1;
+                page = 0;
+            }
+        } else if (action == 'q') {
+            return;
+        }
+    }
+}
+
+void searchMember() {
+    printHeader("SEARCH MEMBER");
+    
+    printf("Search By:\n");
+    printf("1. Member ID\n");
+    printf("2. Name\n");
+    printf("\nChoice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    
+    int found = 0;
+    
+    switch (choice) {
+        case 1: {
+            int id;
+            printf("Enter Member ID: ");
+            scanf("%d", &id);
+            
+            for (int i = 0; i < memberCount; i++) {
+                if (members[i].memberID == id && members[i].isActive) {
+                    printf("\n✓ Member Found:\n");
+                    printf("─────────────────\n");
+                    printf("ID          : %d\n", members[i].memberID);
+                    printf("Name        : %s\n", members[i].name);
+                    printf("Email       : %s\n", members[i].email);
+                    printf("Phone       : %s\n", members[i].phone);
+                    printf("Address     : %s\n", members[i].address);
+                    printf("Tier        : %s\n", tierNames[members[i].tier]);
+                    printf("Books Issued: %d\n", members[i].booksIssued);
+                    printf("Total Fines : Rs. %.2f\n", members[i].totalFines);
+                    found = 1;
+                    break;
+                }
+            }
+            break;
+        }
+        case 2: {
+            char name[MAX_STRING];
+            readSuggested("Enter Name: ", SUGGEST_MEMBER, name);
+            
+            FuzzyMatch matches[MAX_MEMBERS];
+            int count = fuzzySearch(TERM_MEMBER, name, matches, MAX_MEMBERS);
+            
+            printf("\n%-8s %-25s %-30s %-8s %s\n", "ID", "Name", "Email", "Issued", "Match");
+            printf("────────────────────────────────────────────────────────────────────────\n");
+            
+            for (int i = 0; i < count; i++) {
+                Member *member = &members[matches[i].slot];
+                char match[16];
+                if (matches[i].contains) strcpy(match, "exact");
+                else if (matches[i].distance == 0) strcpy(match, "words");
+                else sprintf(match, "~%d", matches[i].distance);
+                
+                printf("%-8d %-25s %-30s %-8d %s\n",
+                       member->memberID, member->name,
+                       member->email, member->booksIssued, match);
+            }
+            found = count > 0;
+            break;
+        }
+        default:
+            printf("\n✗ Invalid choice!\n");
+    }
+    
+    if (!found && (choice == 1 || choice == 2)) {
+        printf("\n✗ No members found!\n");
+    }
+    
+    pauseScreen();
+}
+
+void updateMember() {
+    printHeader("UPDATE MEMBER");
+    
+    int id;
+    printf("Enter Member ID to update: ");
+    scanf("%d", &id);
+    
+    int found = -1;
+    for (int i = 0; i < memberCount; i++) {
+        if (members[i].memberID == id && members[i].isActive) {
+            found = i;
+            break;
+        }
+    }
+    
+    if (found == -1) {
+        printf("\n✗ Member not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\nCurrent Details:\n");
+    printf("─────────────────\n");
+    printf("Name    : %s\n", members[found].name);
+    printf("Email   : %s\n", members[found].email);
+    printf("Phone   : %s\n", members[found].phone);
+    printf("Address : %s\n", members[found].address);
+    printf("Tier    : %s\n", tierNames[members[found].tier]);
+    
+    printf("\nEnter New Details (press Enter to keep current):\n");
+    printf("─────────────────────────────────────────────────\n");
+    
+    char name[MAX_STRING], email[MAX_STRING], phone[MAX_STRING];
+    char address[MAX_STRING], tier[MAX_STRING];
+    
+    printf("Name [%s]: ", members[found].name);
+    scanf(" %[^\n]", name);
+    
+    printf("Email [%s]: ", members[found].email);
+    scanf(" %[^\n]", email);
+    
+    printf("Phone [%s]: ", members[found].phone);
+    scanf(" %[^\n]", phone);
+    
+    printf("Address [%s]: ", members[found].address);
+    scanf(" %[^\n]", address);
+    
+    printf("Tier [%s] (1 Student, 2 Faculty, 3 Staff): ", tierNames[members[found].tier]);
+    scanf(" %[^\n]", tier);
+    
+    sharedBegin();
+    found = findMemberSlot(id);
+    if (found == -1 || !members[found].isActive) {
+        printf("\n✗ Member was removed by another desk!\n");
+        pauseScreen();
+        return;
+    }
+    
+    if (strlen(name) > 0) strcpy(members[found].name, name);
+    if (strlen(email) > 0) strcpy(members[found].email, email);
+    if (strlen(phone) > 0) strcpy(members[found].phone, phone);
+    if (strlen(address) > 0) strcpy(members[found].address, address);
+    if (parseTier(tier) != -1) members[found].tier = parseTier(tier);
+    
+    reindexMember(found);
+    indexMemberTerms(found);
+    saveMembers();
+    emitEvent(EVENT_MEMBER_UPDATED, 0, members[found].memberID, 0, 0);
+    printf("\n✓ Member updated successfully!\n");
+    pauseScreen();
+}
+
+void deleteMember() {
+    printHeader("DELETE MEMBER");
+    
+    int id;
+    printf("Enter Member ID to delete: ");
+    scanf("%d", &id);
+    
+    int found = -1;
+    for (int i = 0; i < memberCount; i++) {
+        if (members[i].memberID == id && members[i].isActive) {
+            found = i;
+            break;
+        }
+    }
+    
+    if (found == -1) {
+        printf("\n✗ Member not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    if (members[found].booksIssued > 0) {
+        printf("\n✗ Cannot delete! Member has issued books.\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\nMember: %s (ID: %d)\n", members[found].name, members[found].memberID);
+    printf("Are you sure you want to delete? (y/n): ");
+    
+    char confirm;
+    scanf(" %c", &confirm);
+    
+    if (confirm == 'y' || confirm == 'Y') {
+        sharedBegin();
+        found = findMemberSlot(id);
+        if (found == -1 || !members[found].isActive) {
+            printf("\n✗ Member was removed by another desk!\n");
+            pauseScreen();
+            return;
+        }
+        if (members[found].booksIssued > 0) {
+            printf("\n✗ Cannot delete! Member has issued books.\n");
+            pauseScreen();
+            return;
+        }
+        
+        members[found].isActive = 0;
+        reindexMember(found);
+        cancelMemberHolds(found, libraryNow());
+        freeMemberSlots[freeMemberCount++] = found;
+        saveHolds();
+        saveBooks();
+        saveMembers();
+        emitEvent(EVENT_MEMBER_DELETED, 0, members[found].memberID, 0, members[found].totalFines);
+        printf("\n✓ Member deleted successfully!\n");
+        compactIfSparse();
+    } else {
+        printf("\n✓ Deletion cancelled.\n");
+    }
+    
+    pauseScreen();
+}
+
+void memberManagementMenu() {
+    while (1) {
+        printHeader("MEMBER MANAGEMENT");
+        
+        printf("1. Add New Member\n");
+        printf("2. View All Members\n");
+        printf("3. Search Member\n");
+        printf("4. Update Member\n");
+        printf("5. Delete Member\n");
+        printf("6. Back to Main Menu\n");
+        printf("\nChoice: ");
+        
+        int choice;
+        scanf("%d", &choice);
+        
+        switch (choice) {
+            case 1: addMember(); break;
+            case 2: viewAllMembers(); break;
+            case 3: searchMember(); break;
+            case 4: updateMember(); break;
+            case 5: deleteMember(); break;
+            case 6: return;
+            default:
+                printf("\n✗ Invalid choice!\n");
+                pauseScreen();
+        }
+    }
+}
+
+void rebuildFreeSlots() {
+    freeBookCount = 0;
+    freeMemberCount = 0;
+    for (int i = bookCount - 1; i >= 0; i--) {
+        if (!books[i].isActive) freeBookSlots[freeBookCount++] = i;
+    }
+    for (int i = memberCount - 1; i >= 0; i--) {
+        if (!members[i].isActive) freeMemberSlots[freeMemberCount++] = i;
+    }
+}
+
+void loadArchive() {
+    archivedBookCount = 0;
+    archivedMemberCount = 0;
+    retiredBookID = 0;
+    retiredMemberID = 0;
+    
+    FILE *file = fopen(dataPath(ARCHIVE_FILE), "rb");
+    if (file == NULL) return;
+    
+    static MemberV1 legacy[MAX_ARCHIVED_MEMBERS];
+    int version = 0;
+    fread(&version, sizeof(int), 1, file);
+    if (version >= 0) {
+        retiredBookID = version;
+    } else {
+        fread(&retiredBookID, sizeof(int), 1, file);
+    }
+    
+    if (fread(&retiredMemberID, sizeof(int), 1, file) != 1 ||
+        fread(&archivedBookCount, sizeof(int), 1, file) != 1 ||
+        archivedBookCount < 0 || archivedBookCount > MAX_ARCHIVED_BOOKS ||
+        fread(archivedBooks, sizeof(Book), archivedBookCount, file) != (size_t)archivedBookCount ||
+        fread(&archivedMemberCount, sizeof(int), 1, file) != 1 ||
+        archivedMemberCount < 0 || archivedMemberCount > MAX_ARCHIVED_MEMBERS ||
+        fread(version >= 0 ? (void *)legacy : (void *)archivedMembers,
+              version >= 0 ? sizeof(MemberV1) : sizeof(Member),
+              archivedMemberCount, file) != (size_t)archivedMemberCount) {
+        printf("Error loading archive!\n");
+        archivedBookCount = 0;
+        archivedMemberCount = 0;
+    } else if (version >= 0) {
+        upgradeMembers(legacy, archivedMembers, archivedMemberCount);
+    }
+    fclose(file);
+    
+    for (int i = 0; i < archivedMemberCount; i++) {
+        if (archivedMembers[i].tier < 0 || archivedMembers[i].tier >= MEMBER_TIER_COUNT) {
+            archivedMembers[i].tier = TIER_STUDENT;
+        }
+    }
+}
+
+void saveArchive() {
+    sharedDirty |= 1 << SHARED_ARCHIVE;
+    FILE *file = fopen(dataPath(ARCHIVE_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving archive!\n");
+        return;
+    }
+    
+    int version = -ARCHIVE_VERSION;
+    fwrite(&version, sizeof(int), 1, file);
+    fwrite(&retiredBookID, sizeof(int), 1, file);
+    fwrite(&retiredMemberID, sizeof(int), 1, file);
+    fwrite(&archivedBookCount, sizeof(int), 1, file);
+    fwrite(archivedBooks, sizeof(Book), archivedBookCount, file);
+    fwrite(&archivedMemberCount, sizeof(int), 1, file);
+    fwrite(archivedMembers, sizeof(Member), archivedMemberCount, file);
+    fclose(file);
+}
+
+const Book *archivedBook(int bookID) {
+    int lo = 0, hi = archivedBookCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (archivedBooks[mid].bookID < bookID) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < archivedBookCount && archivedBooks[lo].bookID == bookID ? &archivedBooks[lo] : NULL;
+}
+
+const Member *archivedMember(int memberID) {
+    int lo = 0, hi = archivedMemberCount;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (archivedMembers[mid].memberID < memberID) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < archivedMemberCount && archivedMembers[lo].memberID == memberID
+           ? &archivedMembers[lo] : NULL;
+}
+
+const Book *bookRecord(int bookID) {
+    int slot = findBookSlot(bookID);
+    return slot != -1 ? &books[slot] : archivedBook(bookID);
+}
+
+const Member *memberRecord(int memberID) {
+    int slot = findMemberSlot(memberID);
+    return slot != -1 ? &members[slot] : archivedMember(memberID);
+}
+
+const char *bookTitleFor(int bookID) {
+    const Book *book = bookRecord(bookID);
+    return book != NULL ? book->title : "Unknown";
+}
+
+const char *memberNameFor(int memberID) {
+    const Member *member = memberRecord(memberID);
+    return member != NULL ? member->name : "Unknown";
+}
+
+int bookReferenced(int bookID) {
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].bookID == bookID) return 1;
+    }
+    for (int i = 0; i < holdCount; i++) {
+        if (holds[i].bookID == bookID) return 1;
+    }
+    for (int i = 0; i < branchLoanCount; i++) {
+        if (branchLoans[i].bookID == bookID) return 1;
+    }
+    return 0;
+}
+
+int memberReferenced(int memberID) {
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].memberID == memberID) return 1;
+    }
+    for (int i = 0; i < holdCount; i++) {
+        if (holds[i].memberID == memberID) return 1;
+    }
+    return 0;
+}
+
+int retireBookSlot(int slot) {
+    Book *book = &books[slot];
+    
+    if (bookReferenced(book->bookID)) {
+        if (archivedBookCount == MAX_ARCHIVED_BOOKS) return 0;
+        int at = archivedBookCount;
+        while (at > 0 && archivedBooks[at - 1].bookID > book->bookID) {
+            archivedBooks[at] = archivedBooks[at - 1];
+            at--;
+        }
+        archivedBooks[at] = *book;
+        archivedBookCount++;
+    }
+    
+    if (branchForBookID(book->bookID) == currentBranch && book->bookID > retiredBookID) {
+        retiredBookID = book->bookID;
+    }
+    return 1;
+}
+
+int retireMemberSlot(int slot) {
+    Member *member = &members[slot];
+    
+    if (memberReferenced(member->memberID)) {
+        if (archivedMemberCount == MAX_ARCHIVED_MEMBERS) return 0;
+        int at = archivedMemberCount;
+        while (at > 0 && archivedMembers[at - 1].memberID > member->memberID) {
+            archivedMembers[at] = archivedMembers[at - 1];
+            at--;
+        }
+        archivedMembers[at] = *member;
+        archivedMemberCount++;
+    }
+    
+    if (branchForMemberID(member->memberID) == currentBranch && member->memberID > retiredMemberID) {
+        retiredMemberID = member->memberID;
+    }
+    return 1;
+}
+
+int allocateBookSlot() {
+    if (freeBookCount > 0) loadBranchLoans();
+    while (freeBookCount > 0) {
+        int slot = freeBookSlots[--freeBookCount];
+        if (!retireBookSlot(slot)) continue;
+        
+        unindexBookSlot(slot);
+        holdQueueHead[slot] = -1;
+        holdQueueTail[slot] = -1;
+        analytics.bookBorrows[slot] = 0;
+        analytics.neighbourSize[slot] = 0;
+        saveAnalyticsRange(&analytics.bookBorrows[slot], sizeof(int));
+        saveAnalyticsRange(&analytics.neighbourSize[slot], sizeof(int));
+        saveArchive();
+        return slot;
+    }
+    return bookCount < MAX_BOOKS ? bookCount++ : -1;
+}
+
+int allocateMemberSlot() {
+    while (freeMemberCount > 0) {
+        int slot = freeMemberSlots[--freeMemberCount];
+        if (!retireMemberSlot(slot)) continue;
+        
+        unindexMemberSlot(slot);
+        memberHoldHead[slot] = -1;
+        analytics.memberBorrows[slot] = 0;
+        saveAnalyticsRange(&analytics.memberBorrows[slot], sizeof(int));
+        saveArchive();
+        return slot;
+    }
+    return memberCount < MAX_MEMBERS ? memberCount++ : -1;
+}
+
+int compactTables() {
+    loadBranchLoans();
+    int reclaimed = 0;
+    int kept = 0;
+    
+    for (int i = 0; i < bookCount; i++) {
+        if (!books[i].isActive && retireBookSlot(i)) {
+            reclaimed++;
+            continue;
+        }
+        analytics.bookBorrows[kept] = analytics.bookBorrows[i];
+        analytics.neighbourSize[kept] = analytics.neighbourSize[i];
+        memcpy(analytics.neighbours[kept], analytics.neighbours[i], sizeof(analytics.neighbours[0]));
+        copyRows[kept] = copyRows[i];
+        copyAvailable[kept] = copyAvailable[i];
+        copyReserved[kept] = copyReserved[i];
+        books[kept++] = books[i];
+    }
+    memset(&analytics.bookBorrows[kept], 0, (bookCount - kept) * sizeof(int));
+    memset(&analytics.neighbourSize[kept], 0, (bookCount - kept) * sizeof(int));
+    bookCount = kept;
+    
+    kept = 0;
+    for (int i = 0; i < memberCount; i++) {
+        if (!members[i].isActive && retireMemberSlot(i)) {
+            reclaimed++;
+            continue;
+        }
+        analytics.memberBorrows[kept] = analytics.memberBorrows[i];
+        memcpy(analytics.recentBorrows[kept], analytics.recentBorrows[i],
+               sizeof(analytics.recentBorrows[0]));
+        members[kept++] = members[i];
+    }
+    memset(&analytics.memberBorrows[kept], 0, (memberCount - kept) * sizeof(int));
+    memberCount = kept;
+    
+    if (reclaimed == 0) return 0;
+    
+    rebuildIDIndexes();
+    rebuildPolicyClasses();
+    rebuildOrderIndexes();
+    rebuildBTrees();
+    rebuildTermIndex();
+    rebuildHoldQueues();
+    rebuildFreeSlots();
+    suggestDirty = 1;
+    
+    saveArchive();
+    saveBooks();
+    saveMembers();
+    saveAnalytics();
+    saveCopies();
+    return reclaimed;
+}
+
+void compactIfSparse() {
+    if ((freeBookCount >= COMPACT_MIN_TOMBSTONES && freeBookCount * 4 >= bookCount) ||
+        (freeMemberCount >= COMPACT_MIN_TOMBSTONES && freeMemberCount * 4 >= memberCount)) {
+        int reclaimed = compactTables();
+        if (reclaimed > 0) {
+            printf("✓ Compacted %d deleted record(s)\n", reclaimed);
+        }
+    }
+}
+
+void loadCopies() {
+    int version = 0, rows = 0;
+    FILE *file = fopen(dataPath(COPIES_FILE), "rb");
+    if (file != NULL) {
+        if (fread(&version, sizeof(int), 1, file) != 1 || version != COPIES_VERSION ||
+            fread(&rows, sizeof(int), 1, file) != 1 || rows > MAX_BOOKS) {
+            rows = 0;
+        }
+        rows = (int)fread(copyRows, sizeof(CopyRow), rows, file);
+        fclose(file);
+    }
+    
+    for (int slot = 0; slot < bookCount; slot++) {
+        if (slot >= rows || copyRows[slot].bookID != books[slot].bookID) {
+            resetCopyRow(slot);
+        }
+        rebuildCopyBitmaps(slot);
+        if (books[slot].isActive) syncCopies(slot);
+    }
+    
+    int assigned = 0;
+    for (int i = 0; i < transactionCount; i++) {
+        Transaction *trans = &transactions[i];
+        if (trans->isReturned || trans->copyBarcode != 0) continue;
+        
+        int slot = findBookSlot(trans->bookID);
+        if (slot == -1) continue;
+        int copy = takeCopy(slot, copyReserved[slot] != 0 ? COPY_RESERVED : COPY_AVAILABLE);
+        if (copy == -1) continue;
+        
+        if (copyRows[slot].items[copy].status == COPY_AVAILABLE) {
+            books[slot].availableCopies--;
+        }
+        setCopyStatus(slot, copy, COPY_ON_LOAN);
+        copyRows[slot].items[copy].loan = i;
+        trans->copyBarcode = copyRows[slot].items[copy].barcode;
+        assigned++;
+    }
+    if (assigned > 0) saveTransactions();
+    
+    saveCopies();
+}
+
+void rebuildCopyBitmaps(int slot) {
+    copyAvailable[slot] = 0;
+    copyReserved[slot] = 0;
+    for (int c = 0; c < copyRows[slot].count; c++) {
+        if (copyRows[slot].items[c].status == COPY_AVAILABLE) copyAvailable[slot] |= 1ULL << c;
+        if (copyRows[slot].items[c].status == COPY_RESERVED) copyReserved[slot] |= 1ULL << c;
+    }
+}
+
+void saveCopies() {
+    sharedDirty |= 1 << SHARED_COPIES;
+    FILE *file = fopen(dataPath(COPIES_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving copies!\n");
+        return;
+    }
+    
+    int version = COPIES_VERSION;
+    fwrite(&version, sizeof(int), 1, file);
+    fwrite(&bookCount, sizeof(int), 1, file);
+    fwrite(copyRows, sizeof(CopyRow), bookCount, file);
+    fclose(file);
+    recordChecksums(CHECKED_COPIES, copyRows, bookCount, 0, bookCount);
+}
+
+void saveCopyRange(const void *field, size_t size) {
+    sharedDirty |= 1 << SHARED_COPIES;
+    FILE *file = fopen(dataPath(COPIES_FILE), "r+b");
+    if (file == NULL) {
+        saveCopies();
+        return;
+    }
+    
+    size_t offset = (const char *)field - (const char *)copyRows;
+    fseek(file, (long)(2 * sizeof(int) + offset), SEEK_SET);
+    fwrite(field, 1, size, file);
+    fclose(file);
+    recordChecksums(CHECKED_COPIES, copyRows, bookCount, (int)(offset / sizeof(CopyRow)),
+                    (int)((offset + size - 1) / sizeof(CopyRow)) + 1);
+}
+
+void resetCopyRow(int slot) {
+    memset(&copyRows[slot], 0, sizeof(CopyRow));
+    copyRows[slot].bookID = books[slot].bookID;
+    copyAvailable[slot] = 0;
+    copyReserved[slot] = 0;
+}
+
+void setCopyStatus(int slot, int copy, int status) {
+    unsigned long long bit = 1ULL << copy;
+    copyRows[slot].items[copy].status = status;
+    copyRows[slot].items[copy].loan = -1;
+    copyAvailable[slot] = status == COPY_AVAILABLE ? copyAvailable[slot] | bit : copyAvailable[slot] & ~bit;
+    copyReserved[slot] = status == COPY_RESERVED ? copyReserved[slot] | bit : copyReserved[slot] & ~bit;
+}
+
+int addCopy(int slot) {
+    CopyRow *row = &copyRows[slot];
+    int copy = -1;
+    for (int c = 0; c < row->count && copy == -1; c++) {
+        if (row->items[c].status == COPY_NONE) copy = c;
+    }
+    for (int c = 0; c < row->count && copy == -1; c++) {
+        if (row->items[c].status == COPY_WITHDRAWN) copy = c;
+    }
+    if (copy == -1) {
+        if (row->count == MAX_COPIES_PER_BOOK) return -1;
+        copy = row->count++;
+    }
+    
+    row->items[copy].barcode = books[slot].bookID * COPY_BARCODE_SPAN + copy + 1;
+    setCopyStatus(slot, copy, COPY_AVAILABLE);
+    return copy;
+}
+
+int takeCopy(int slot, int status) {
+    unsigned long long bits = status == COPY_RESERVED ? copyReserved[slot] : copyAvailable[slot];
+    return bits != 0 ? __builtin_ctzll(bits) : -1;
+}
+
+void syncCopies(int slot) {
+    int circulating = __builtin_popcountll(copyAvailable[slot]) +
+                      __builtin_popcountll(copyReserved[slot]);
+    for (int c = 0; c < copyRows[slot].count; c++) {
+        if (copyRows[slot].items[c].status == COPY_ON_LOAN) circulating++;
+    }
+    
+    while (circulating < books[slot].totalCopies && addCopy(slot) != -1) {
+        circulating++;
+    }
+    while (circulating > books[slot].totalCopies) {
+        int copy = takeCopy(slot, COPY_AVAILABLE);
+        if (copy == -1) copy = takeCopy(slot, COPY_RESERVED);
+        if (copy == -1) break;
+        setCopyStatus(slot, copy, COPY_WITHDRAWN);
+        circulating--;
+    }
+    
+    int available = __builtin_popcountll(copyAvailable[slot]);
+    while (available > books[slot].availableCopies) {
+        setCopyStatus(slot, takeCopy(slot, COPY_AVAILABLE), COPY_RESERVED);
+        available--;
+    }
+    while (available < books[slot].availableCopies && copyReserved[slot] != 0) {
+        setCopyStatus(slot, takeCopy(slot, COPY_RESERVED), COPY_AVAILABLE);
+        available++;
+    }
+}
+
+int findCopy(int barcode, int *copy) {
+    int slot = findBookSlot(barcode / COPY_BARCODE_SPAN);
+    int c = barcode % COPY_BARCODE_SPAN - 1;
+    if (slot == -1 || c < 0 || c >= copyRows[slot].count ||
+        copyRows[slot].items[c].barcode != barcode) {
+        return -1;
+    }
+    
+    *copy = c;
+    return slot;
+}
+
+int shelveCopy(int slot, int copy, time_t now) {
+    if (!books[slot].isActive) {
+        setCopyStatus(slot, copy, COPY_WITHDRAWN);
+        books[slot].totalCopies--;
+        return -1;
+    }
+    
+    int reservedHold = dispatchHold(slot, now);
+    if (reservedHold == -1) {
+        setCopyStatus(slot, copy, COPY_AVAILABLE);
+        books[slot].availableCopies++;
+        reindexBook(slot);
+    } else {
+        setCopyStatus(slot, copy, COPY_RESERVED);
+        saveHolds();
+    }
+    return reservedHold;
+}
+
+void manageCopies() {
+    printHeader("MANAGE COPIES");
+    
+    int id;
+    printf("Enter Book ID: ");
+    scanf("%d", &id);
+    
+    int slot = findBookSlot(id);
+    if (slot == -1 || !books[slot].isActive) {
+        printf("\n✗ Book not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    CopyRow *row = &copyRows[slot];
+    printf("\n%s by %s\n\n", books[slot].title, books[slot].author);
+    printf("%-10s %-12s %-8s %-20s %-12s\n", "Barcode", "Status", "Trans", "Member", "Due Date");
+    printf("────────────────────────────────────────────────────────────────\n");
+    for (int c = 0; c < row->count; c++) {
+        Copy *item = &row->items[c];
+        if (item->status == COPY_NONE) continue;
+        if (item->status == COPY_ON_LOAN) {
+            Transaction *trans = &transactions[item->loan];
+            char dueStr[12];
+            formatDate(trans->dueDate, dueStr);
+            printf("%-10d %-12s %-8d %-20s %-12s\n", item->barcode, copyStatusNames[item->status],
+                   trans->transactionID, memberNameFor(trans->memberID), dueStr);
+        } else {
+            printf("%-10d %-12s\n", item->barcode, copyStatusNames[item->status]);
+        }
+    }
+    
+    printf("\n1. Add Copy\n");
+    printf("2. Mark Copy Damaged\n");
+    printf("3. Mark Copy Lost\n");
+    printf("4. Put Copy Back on Shelf\n");
+    printf("5. Back\n");
+    printf("\nChoice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    if (choice < 1 || choice > 4) return;
+    
+    int barcode = 0, copy;
+    if (choice != 1) {
+        printf("Copy barcode: ");
+        scanf("%d", &barcode);
+    }
+    
+    sharedBegin();
+    slot = findBookSlot(id);
+    if (slot == -1 || !books[slot].isActive) {
+        printf("\n✗ Book was removed by another desk!\n");
+        pauseScreen();
+        return;
+    }
+    row = &copyRows[slot];
+    
+    if (choice == 1) {
+        copy = addCopy(slot);
+        if (copy == -1) {
+            printf("\n✗ A title can have at most %d copies!\n", MAX_COPIES_PER_BOOK);
+            pauseScreen();
+            return;
+        }
+        books[slot].totalCopies++;
+        int reservedHold = shelveCopy(slot, copy, libraryNow());
+        saveCopies();
+        saveBooks();
+        printf("\n✓ Copy %d added%s\n", row->items[copy].barcode,
+               reservedHold != -1 ? " and reserved for the next hold" : "");
+        pauseScreen();
+        return;
+    }
+    
+    if (findCopy(barcode, &copy) != slot) {
+        printf("\n✗ Copy not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    int status = row->items[copy].status;
+    if (choice == 4) {
+        if (status != COPY_DAMAGED && status != COPY_LOST) {
+            printf("\n✗ Copy is not damaged or lost!\n");
+            pauseScreen();
+            return;
+        }
+        books[slot].totalCopies++;
+        int reservedHold = shelveCopy(slot, copy, libraryNow());
+        printf("\n✓ Copy %d back on %s\n", barcode,
+               reservedHold != -1 ? "the hold shelf" : "the shelf");
+    } else {
+        if (status != COPY_AVAILABLE) {
+            printf("\n✗ Only copies on the shelf can be marked (copy is %s)!\n",
+                   copyStatusNames[status]);
+            pauseScreen();
+            return;
+        }
+        setCopyStatus(slot, copy, choice == 2 ? COPY_DAMAGED : COPY_LOST);
+        books[slot].totalCopies--;
+        books[slot].availableCopies--;
+        reindexBook(slot);
+        printf("\n✓ Copy %d marked %s\n", barcode, choice == 2 ? "damaged" : "lost");
+    }
+    
+    saveCopyRange(&row->items[copy], sizeof(Copy));
+    saveBooks();
+    pauseScreen();
+}
+
+int parseTier(const char *text) {
+    int number = atoi(text);
+    if (number >= 1 && number <= MEMBER_TIER_COUNT) return number - 1;
+    for (int t = 0; t < MEMBER_TIER_COUNT; t++) {
+        if (compareFolded(text, tierNames[t]) == 0) return t;
+    }
+    return -1;
+}
+
+const char *nextPolicyToken(const char *text, char *out, int size) {
+    int length = 0;
+    while (isspace((unsigned char)*text)) text++;
+    
+    if (*text == '"') {
+        text++;
+        while (*text != '\0' && *text != '"') {
+            if (length < size - 1) out[length++] = *text;
+            text++;
+        }
+        if (*text == '"') text++;
+    } else {
+        while (*text != '\0' && !isspace((unsigned char)*text)) {
+            if (length < size - 1) out[length++] = *text;
+            text++;
+        }
+    }
+    out[length] = '\0';
+    return text;
+}
+
+void defaultPolicy() {
+    LoanPolicy policy;
+    policy.loanDays = MAX_BORROW_DAYS;
+    for (int t = 0; t < FINE_TIER_COUNT; t++) {
+        policy.fineStart[t] = fineTierStart[t];
+        policy.fineEnd[t] = t + 1 < FINE_TIER_COUNT ? fineTierStart[t + 1] : INT_MAX;
+        policy.fineRate[t] = fineTierRate[t];
+    }
+    
+    policyClassCount = 1;
+    strcpy(policyClasses[0], "*");
+    for (int t = 0; t < MEMBER_TIER_COUNT; t++) {
+        loanLimits[t] = MAX_BOOKS_PER_MEMBER;
+        loanPolicies[t][0] = policy;
+    }
+}
+
+int policyClassFor(const char *category, int create) {
+    for (int c = 1; c < policyClassCount; c++) {
+        if (compareFolded(category, policyClasses[c]) == 0) return c;
+    }
+    if (!create || policyClassCount == MAX_POLICY_CLASSES) return 0;
+    
+    int c = policyClassCount++;
+    strncpy(policyClasses[c], category, MAX_STRING - 1);
+    policyClasses[c][MAX_STRING - 1] = '\0';
+    for (int t = 0; t < MEMBER_TIER_COUNT; t++) {
+        loanPolicies[t][c] = loanPolicies[t][0];
+    }
+    return c;
+}
+
+int compilePolicyLine(const char *line, char *error) {
+    char text[POLICY_LINE_MAX], keyword[MAX_STRING], tierText[MAX_STRING];
+    char category[MAX_STRING], value[MAX_STRING];
+    strncpy(text, line, POLICY_LINE_MAX - 1);
+    text[POLICY_LINE_MAX - 1] = '\0';
+    char *comment = strchr(text, '#');
+    if (comment != NULL) *comment = '\0';
+    
+    const char *rest = nextPolicyToken(text, keyword, MAX_STRING);
+    if (keyword[0] == '\0') return 1;
+    
+    rest = nextPolicyToken(rest, tierText, MAX_STRING);
+    int all = strcmp(tierText, "*") == 0;
+    int tier = all ? 0 : parseTier(tierText);
+    if (tier == -1) {
+        sprintf(error, "unknown tier '%.40s'", tierText);
+        return 0;
+    }
+    int lastTier = all ? MEMBER_TIER_COUNT - 1 : tier;
+    
+    if (strcmp(keyword, "limit") == 0) {
+        nextPolicyToken(rest, value, MAX_STRING);
+        int limit = atoi(value);
+        if (limit < 1 || limit > MAX_LOAN_LIMIT) {
+            sprintf(error, "limit must be between 1 and %d", MAX_LOAN_LIMIT);
+            return 0;
+        }
+        for (int t = tier; t <= lastTier; t++) {
+            loanLimits[t] = limit;
+        }
+        return 1;
+    }
+    if (strcmp(keyword, "loan") != 0) {
+        sprintf(error, "unknown rule '%.40s'", keyword);
+        return 0;
+    }
+    
+    LoanPolicy policy;
+    rest = nextPolicyToken(rest, category, MAX_STRING);
+    rest = nextPolicyToken(rest, value, MAX_STRING);
+    policy.loanDays = atoi(value);
+    if (category[0] == '\0' || policy.loanDays < 1 || policy.loanDays > MAX_LOAN_DAYS) {
+        sprintf(error, "expected: loan <tier> <category> <days 1-%d> <from>:<rate> ...", MAX_LOAN_DAYS);
+        return 0;
+    }
+    for (int t = 0; t < FINE_TIER_COUNT; t++) {
+        rest = nextPolicyToken(rest, value, MAX_STRING);
+        if (sscanf(value, "%d:%f", &policy.fineStart[t], &policy.fineRate[t]) != 2 ||
+            policy.fineRate[t] < 0 || policy.fineStart[t] < (t == 0 ? 0 : policy.fineStart[t - 1] + 1)) {
+            sprintf(error, "expected %d fine bands <from day>:<rate per day> in increasing order",
+                    FINE_TIER_COUNT);
+            return 0;
+        }
+    }
+    for (int t = 0; t < FINE_TIER_COUNT; t++) {
+        policy.fineEnd[t] = t + 1 < FINE_TIER_COUNT ? policy.fineStart[t + 1] : INT_MAX;
+    }
+    
+    int firstClass = 0, lastClass = policyClassCount - 1;
+    if (strcmp(category, "*") != 0) {
+        firstClass = lastClass = policyClassFor(category, 1);
+        if (firstClass == 0) {
+            sprintf(error, "too many categories (at most %d)", MAX_POLICY_CLASSES - 1);
+            return 0;
+        }
+    }
+    for (int t = tier; t <= lastTier; t++) {
+        for (int c = firstClass; c <= lastClass; c++) {
+            loanPolicies[t][c] = policy;
+        }
+    }
+    return 1;
+}
+
+void loadPolicy() {
+    defaultPolicy();
+    
+    FILE *file = fopen(dataPath(POLICY_FILE), "r");
+    if (file == NULL) {
+        file = fopen(dataPath(POLICY_FILE), "w");
+        if (file == NULL) return;
+        
+        fprintf(file, "# Circulation policy, compiled into a lookup table at startup.\n");
+        fprintf(file, "#\n");
+        fprintf(file, "#   limit <tier|*> <books>\n");
+        fprintf(file, "#   loan <tier|*> <category|*> <days> <from>:<rate> <from>:<rate> <from>:<rate>\n");
+        fprintf(file, "#\n");
+        fprintf(file, "# Tiers are student, faculty and staff. Each fine band charges <rate> per day\n");
+        fprintf(file, "# from <from> days overdue until the next band starts. Quote categories that\n");
+        fprintf(file, "# contain spaces. Later lines override earlier ones, so put '*' rules first.\n");
+        fprintf(file, "#\n");
+        fprintf(file, "#   loan faculty * 28 0:1 14:2 28:3\n");
+        fprintf(file, "#   loan * Reference 3 0:10 2:20 5:30\n\n");
+        fprintf(file, "limit * %d\n", MAX_BOOKS_PER_MEMBER);
+        fprintf(file, "loan * * %d", MAX_BORROW_DAYS);
+        for (int t = 0; t < FINE_TIER_COUNT; t++) {
+            fprintf(file, " %d:%g", fineTierStart[t], fineTierRate[t]);
+        }
+        fprintf(file, "\n");
+        fclose(file);
+        return;
+    }
+    
+    char line[POLICY_LINE_MAX], error[MAX_STRING];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        if (!compilePolicyLine(line, error)) {
+            fprintf(stderr, "%s:%d: %s\n", POLICY_FILE, lineNumber, error);
+        }
+    }
+    fclose(file);
+}
+
+void classifyBook(int slot) {
+    bookPolicyClass[slot] = (unsigned char)policyClassFor(books[slot].category, 0);
+}
+
+void rebuildPolicyClasses() {
+    for (int slot = 0; slot < bookCount; slot++) {
+        classifyBook(slot);
+    }
+}
+
+const LoanPolicy *loanPolicy(int bookIndex, int memberIndex) {
+    return &loanPolicies[memberIndex != -1 ? members[memberIndex].tier : TIER_STUDENT]
+                        [bookIndex != -1 ? bookPolicyClass[bookIndex] : 0];
+}
+
+const LoanPolicy *transactionPolicy(const Transaction *trans) {
+    int tier = trans->tier >= 0 && trans->tier < MEMBER_TIER_COUNT ? trans->tier : TIER_STUDENT;
+    int policyClass = trans->policyClass >= 0 && trans->policyClass < policyClassCount
+                    ? trans->policyClass : 0;
+    return &loanPolicies[tier][policyClass];
+}
+
+int renderPolicy() {
+    if (renderMode == RENDER_TSV) {
+        renderf("tier\tcategory\tlimit\tdays");
+        for (int f = 0; f < FINE_TIER_COUNT; f++) {
+            renderf("\tfrom%d\trate%d", f + 1, f + 1);
+        }
+        renderf("\n");
+    } else {
+        renderf("%-10s %-24s %6s %6s  %s\n", "Tier", "Category", "Limit", "Days", "Fines (from day:rate)");
+        renderf("────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int t = 0; t < MEMBER_TIER_COUNT; t++) {
+        for (int c = 0; c < policyClassCount; c++) {
+            const LoanPolicy *policy = &loanPolicies[t][c];
+            if (renderMode == RENDER_TSV) {
+                renderf("%s\t%s\t%d\t%d", tierNames[t], policyClasses[c], loanLimits[t], policy->loanDays);
+                for (int f = 0; f < FINE_TIER_COUNT; f++) {
+                    renderf("\t%d\t%.2f", policy->fineStart[f], policy->fineRate[f]);
+                }
+            } else {
+                renderf("%-10s %-24.24s %6d %6d ", tierNames[t], policyClasses[c], loanLimits[t],
+                        policy->loanDays);
+                for (int f = 0; f < FINE_TIER_COUNT; f++) {
+                    renderf(" %d:%.2f", policy->fineStart[f], policy->fineRate[f]);
+                }
+            }
+            renderf("\n");
+        }
+    }
+    return MEMBER_TIER_COUNT * policyClassCount;
+}
+
+float fineForDaysLate(const LoanPolicy *policy, int daysLate) {
+    float fine = 0.0;
+    for (int t = 0; t < FINE_TIER_COUNT; t++) {
+        int days = daysLate - policy->fineStart[t];
+        int width = policy->fineEnd[t] - policy->fineStart[t];
+        days = days < 0 ? 0 : days;
+        days = days > width ? width : days;
+        fine += days * policy->fineRate[t];
+    }
+    return fine;
+}
+
+void calculateFine(Transaction *trans, const LoanPolicy *policy) {
+    if (trans->isReturned) {
+        int daysLate = getDaysDifference(trans->dueDate, trans->returnDate);
+        trans->fine = fineForDaysLate(policy, daysLate);
+    }
+}
+
+int accrueOpenFines(time_t asOf, int *transIndex, float *fines) {
+    static time_t openDue[MAX_TRANSACTIONS];
+    static const LoanPolicy *openPolicy[MAX_TRANSACTIONS];
+    int openCount = 0;
+    
+    for (int i = 0; i < transactionCount; i++) {
+        transIndex[openCount] = i;
+        openDue[openCount] = transactions[i].dueDate;
+        openPolicy[openCount] = transactionPolicy(&transactions[i]);
+        openCount += !transactions[i].isReturned;
+    }
+    
+    for (int i = 0; i < openCount; i++) {
+        int daysLate = (int)(asOf - openDue[i]) / SECONDS_PER_DAY;
+        fines[i] = fineForDaysLate(openPolicy[i], daysLate);
+    }
+    
+    return openCount;
+}
+
+float accruedFinesForMember(int memberID, time_t asOf) {
+    static int transIndex[MAX_TRANSACTIONS];
+    static float fines[MAX_TRANSACTIONS];
+    
+    int openCount = accrueOpenFines(asOf, transIndex, fines);
+    float total = 0.0;
+    for (int i = 0; i < openCount; i++) {
+        total += (transactions[transIndex[i]].memberID == memberID) ? fines[i] : 0.0f;
+    }
+    return total;
+}
+
+time_t parseDate(const char *text) {
+    struct tm date;
+    memset(&date, 0, sizeof(date));
+    
+    if (sscanf(text, "%d-%d-%d", &date.tm_year, &date.tm_mon, &date.tm_mday) != 3) {
+        return (time_t)-1;
+    }
+    
+    date.tm_year -= 1900;
+    date.tm_mon -= 1;
+    date.tm_hour = 23;
+    date.tm_min = 59;
+    date.tm_sec = 59;
+    date.tm_isdst = -1;
+    return mktime(&date);
+}
+
+int renderLiabilities(time_t asOf) {
+    static int transIndex[MAX_TRANSACTIONS];
+    static float fines[MAX_TRANSACTIONS];
+    static float memberAccrued[MAX_MEMBERS];
+    static int memberOverdue[MAX_MEMBERS];
+    
+    memset(memberAccrued, 0, sizeof(memberAccrued));
+    memset(memberOverdue, 0, sizeof(memberOverdue));
+    
+    int openCount = accrueOpenFines(asOf, transIndex, fines);
+    float totalAccrued = 0.0, totalPaidFines = 0.0;
+    int overdueLoans = 0;
+    
+    for (int i = 0; i < openCount; i++) {
+        int memberIndex = findMemberSlot(transactions[transIndex[i]].memberID);
+        if (memberIndex != -1 && fines[i] > 0) {
+            memberAccrued[memberIndex] += fines[i];
+            memberOverdue[memberIndex]++;
+        }
+        totalAccrued += fines[i];
+        overdueLoans += fines[i] > 0;
+    }
+    
+    char asOfStr[12];
+    strftime(asOfStr, 12, "%Y-%m-%d", localtime(&asOf));
+    renderf("\nAccrued fines on open loans as of %s\n\n", asOfStr);
+    
+    renderf("%-8s %-25s %-10s %-14s %-14s\n",
+            "ID", "Name", "Overdue", "Accrued", "Recorded");
+    renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    
+    for (int i = 0; i < memberCount; i++) {
+        if (memberOverdue[i] > 0) {
+            renderf("%-8d %-25s %-10d Rs. %-10.2f Rs. %-10.2f\n",
+                    members[i].memberID, members[i].name, memberOverdue[i],
+                    memberAccrued[i], members[i].totalFines);
+        }
+        if (members[i].isActive) {
+            totalPaidFines += members[i].totalFines;
+        }
+    }
+    
+    renderf("\nOpen Loans        : %d\n", openCount);
+    renderf("Overdue Loans     : %d\n", overdueLoans);
+    renderf("Accrued (unpaid)  : Rs. %.2f\n", totalAccrued);
+    renderf("Recorded Fines    : Rs. %.2f\n", totalPaidFines);
+    renderf("Total Liabilities : Rs. %.2f\n", totalAccrued + totalPaidFines);
+    
+    return openCount;
+}
+
+void outstandingLiabilitiesReport() {
+    printHeader("OUTSTANDING LIABILITIES");
+    
+    char input[MAX_STRING];
+    printf("As of date (YYYY-MM-DD, or 'today'): ");
+    scanf(" %[^\n]", input);
+    
+    time_t asOf = libraryNow();
+    if (strcmp(input, "today") != 0) {
+        asOf = parseDate(input);
+        if (asOf == (time_t)-1) {
+            printf("\n✗ Invalid date!\n");
+            pauseScreen();
+            return;
+        }
+    }
+    
+    renderBegin(stdout, RENDER_TABLE);
+    renderLiabilities(asOf);
+    renderEnd();
+    
+    pauseScreen();
+}
+
+int performIssue(int bookIndex, int memberIndex, int copy, time_t now) {
+    sharedBegin();
+    int transIndex = issueCopy(bookIndex, memberIndex, copy, now);
+    sharedEnd();
+    return transIndex;
+}
+
+int issueCopy(int bookIndex, int memberIndex, int copy, time_t now) {
+    expireHolds(now);
+    int readyHold = findReadyHold(bookIndex, members[memberIndex].memberID);
+    
+    if (copy == -1) {
+        copy = takeCopy(bookIndex, readyHold != -1 ? COPY_RESERVED : COPY_AVAILABLE);
+    }
+    int status = copy != -1 ? copyRows[bookIndex].items[copy].status : COPY_NONE;
+    if (status != COPY_AVAILABLE && (status != COPY_RESERVED || readyHold == -1)) {
+        return ISSUE_UNAVAILABLE;
+    }
+    if (members[memberIndex].booksIssued >= loanLimits[members[memberIndex].tier]) {
+        return ISSUE_LIMIT_REACHED;
+    }
+    if (transactionCount >= MAX_TRANSACTIONS) {
+        return ISSUE_LOG_FULL;
+    }
+    
+    Transaction newTrans;
+    newTrans.transactionID = generateTransactionID();
+    newTrans.bookID = books[bookIndex].bookID;
+    newTrans.memberID = members[memberIndex].memberID;
+    newTrans.issueDate = now;
+    newTrans.dueDate = newTrans.issueDate +
+                       (time_t)loanPolicy(bookIndex, memberIndex)->loanDays * SECONDS_PER_DAY;
+    newTrans.returnDate = 0;
+    newTrans.fine = 0.0;
+    newTrans.isReturned = 0;
+    newTrans.copyBarcode = copyRows[bookIndex].items[copy].barcode;
+    newTrans.tier = members[memberIndex].tier;
+    newTrans.policyClass = bookPolicyClass[bookIndex];
+    
+    transactions[transactionCount++] = newTrans;
+    scheduleReminders(transactionCount - 1);
+    if (readyHold != -1) {
+        holds[readyHold].status = HOLD_FULFILLED;
+        readyHoldCount--;
+        if (status == COPY_AVAILABLE) {
+            int reserved = takeCopy(bookIndex, COPY_RESERVED);
+            setCopyStatus(bookIndex, reserved, COPY_AVAILABLE);
+            saveCopyRange(&copyRows[bookIndex].items[reserved], sizeof(Copy));
+        }
+        saveHolds();
+    } else {
+        books[bookIndex].availableCopies--;
+        reindexBook(bookIndex);
+    }
+    setCopyStatus(bookIndex, copy, COPY_ON_LOAN);
+    copyRows[bookIndex].items[copy].loan = transactionCount - 1;
+    members[memberIndex].booksIssued++;
+    recordIssueAnalytics(bookIndex, memberIndex, newTrans.issueDate);
+    recordCoBorrows(bookIndex, memberIndex, 1);
+    recordLoanDelta(transactionCount - 1, 1, newTrans.issueDate);
+    recordCirculation(books[bookIndex].category, newTrans.issueDate, 1, 0, 0, 1);
+    
+    saveTransactions();
+    saveReminders();
+    saveBooks();
+    saveMembers();
+    saveCopyRange(&copyRows[bookIndex].items[copy], sizeof(Copy));
+    saveAnalyticsRange(&analytics.bookBorrows[bookIndex], sizeof(int));
+    saveAnalyticsRange(&analytics.memberBorrows[memberIndex], sizeof(int));
+    saveAnalyticsRange(analyticsPane(newTrans.issueDate), sizeof(AnalyticsPane));
+    emitEvent(EVENT_BOOK_ISSUED, newTrans.bookID, newTrans.memberID, newTrans.transactionID, 0);
+    
+    return transactionCount - 1;
+}
+
+int performReturn(int transIndex, time_t now) {
+    sharedBegin();
+    int reservedHold = returnCopy(transIndex, now);
+    sharedEnd();
+    return reservedHold;
+}
+
+int returnCopy(int transIndex, time_t now) {
+    Transaction *trans = &transactions[transIndex];
+    trans->returnDate = now;
+    trans->isReturned = 1;
+    
+    int bookIndex = findBookSlot(trans->bookID);
+    int memberIndex = findMemberSlot(trans->memberID);
+    
+    calculateFine(trans, transactionPolicy(trans));
+    recordLoanDelta(transIndex, 0, now);
+    cancelReminders(transIndex);
+    
+    const Book *book = bookRecord(trans->bookID);
+    recordCirculation(book != NULL ? book->category : "", now, 0, 1, trans->fine, 1);
+    
+    int reservedHold = -1;
+    int copy = -1;
+    if (bookIndex != -1 && findCopy(trans->copyBarcode, &copy) == bookIndex &&
+        copyRows[bookIndex].items[copy].loan == transIndex) {
+        reservedHold = shelveCopy(bookIndex, copy, trans->returnDate);
+        saveCopyRange(&copyRows[bookIndex].items[copy], sizeof(Copy));
+    } else if (bookIndex != -1 && books[bookIndex].isActive) {
+        reservedHold = dispatchHold(bookIndex, trans->returnDate);
+        if (reservedHold == -1) {
+            books[bookIndex].availableCopies++;
+            reindexBook(bookIndex);
+        } else {
+            saveHolds();
+        }
+        syncCopies(bookIndex);
+        saveCopies();
+    }
+    
+    if (memberIndex != -1) {
+        members[memberIndex].booksIssued--;
+        members[memberIndex].totalFines += trans->fine;
+    }
+    
+    saveTransactions();
+    saveReminders();
+    saveBooks();
+    saveMembers();
+    emitEvent(EVENT_BOOK_RETURNED, trans->bookID, trans->memberID,
+              trans->transactionID, trans->fine);
+    
+    if (bookIndex != -1 && trans->fine > 0) {
+        recordOverdueAnalytics(bookIndex, trans->returnDate);
+        saveAnalyticsRange(&analytics.authorSize,
+                           sizeof(int) + sizeof(analytics.authorOverdue));
+        saveAnalyticsRange(analyticsPane(trans->returnDate), sizeof(AnalyticsPane));
+    }
+    
+    return reservedHold;
+}
+
+int findOpenLoan(int bookID, int memberID) {
+    int found = -1;
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].bookID != bookID || transactions[i].isReturned) continue;
+        if (memberID != 0 && transactions[i].memberID != memberID) continue;
+        if (found != -1) return -1;
+        found = i;
+    }
+    return found;
+}
+
+void issueBook() {
+    printHeader("ISSUE BOOK");
+    
+    int bookID, memberID;
+    
+    printf("Enter Book ID: ");
+    scanf("%d", &bookID);
+    
+    printf("Enter Member ID: ");
+    scanf("%d", &memberID);
+    sharedBegin();
+    
+    int bookIndex = findBookSlot(bookID);
+    if (bookIndex == -1 || !books[bookIndex].isActive) {
+        printf("\n✗ Book not found!\n");
+        printOwningBranch("Book", branchForBookID(bookID));
+        pauseScreen();
+        return;
+    }
+    
+    int memberIndex = findMemberSlot(memberID);
+    if (memberIndex == -1 || !members[memberIndex].isActive) {
+        printf("\n✗ Member not found!\n");
+        printOwningBranch("Member", branchForMemberID(memberID));
+        pauseScreen();
+        return;
+    }
+    
+    int transIndex = performIssue(bookIndex, memberIndex, -1, libraryNow());
+    
+    if (transIndex == ISSUE_UNAVAILABLE) {
+        printf("\n✗ Book not available! All copies issued.\n");
+        printf("Place a hold for %s? (y/n): ", members[memberIndex].name);
+        sharedEnd();
+        
+        char confirm;
+        scanf(" %c", &confirm);
+        
+        if (confirm == 'y' || confirm == 'Y') {
+            sharedBegin();
+            bookIndex = findBookSlot(bookID);
+            memberIndex = findMemberSlot(memberID);
+            int h = -1;
+            if (bookIndex != -1 && books[bookIndex].isActive &&
+                memberIndex != -1 && members[memberIndex].isActive) {
+                h = placeHold(bookIndex, memberIndex, libraryNow());
+            }
+            if (h == -1) {
+                printf("\n✗ Hold could not be placed (already on hold or hold limit reached).\n");
+            } else {
+                saveHolds();
+                printf("\n✓ Hold %d placed. Position in queue: %d\n",
+                       holds[h].holdID, holdQueuePosition(h));
+            }
+        }
+        pauseScreen();
+        return;
+    }
+    
+    if (transIndex == ISSUE_LIMIT_REACHED) {
+        printf("\n✗ Member has already issued maximum books (%d)!\n",
+               loanLimits[members[memberIndex].tier]);
+        pauseScreen();
+        return;
+    }
+    
+    if (transIndex == ISSUE_LOG_FULL) {
+        printf("\n✗ Transaction limit reached!\n");
+        pauseScreen();
+        return;
+    }
+    
+    Transaction *trans = &transactions[transIndex];
+    char issueStr[12], dueStr[12];
+    formatDate(trans->issueDate, issueStr);
+    formatDate(trans->dueDate, dueStr);
+    
+    printf("\n✓ Book issued successfully!\n");
+    printf("─────────────────────────────\n");
+    printf("Transaction ID : %d\n", trans->transactionID);
+    printf("Book           : %s\n", books[bookIndex].title);
+    printf("Copy           : %d\n", trans->copyBarcode);
+    printf("Member         : %s\n", members[memberIndex].name);
+    printf("Issue Date     : %s\n", issueStr);
+    printf("Due Date       : %s\n", dueStr);
+    printf("─────────────────────────────\n");
+    printf("Note: Please return within %d days to avoid fine.\n",
+           (int)((trans->dueDate - trans->issueDate) / SECONDS_PER_DAY));
+    
+    pauseScreen();
+}
+
+void returnBook() {
+    printHeader("RETURN BOOK");
+    
+    int transID;
+    printf("Enter Transaction ID: ");
+    scanf("%d", &transID);
+    sharedBegin();
+    
+    int transIndex = -1;
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].transactionID == transID && !transactions[i].isReturned) {
+            transIndex = i;
+            break;
+        }
+    }
+    
+    if (transIndex == -1) {
+        printf("\n✗ Transaction not found or book already returned!\n");
+        pauseScreen();
+        return;
+    }
+    
+    int reservedHold = performReturn(transIndex, libraryNow());
+    Transaction *trans = &transactions[transIndex];
+    int bookIndex = findBookSlot(trans->bookID);
+    int memberIndex = findMemberSlot(trans->memberID);
+    
+    char returnStr[12];
+    formatDate(trans->returnDate, returnStr);
+    
+    printf("\n✓ Book returned successfully!\n");
+    printf("─────────────────────────────\n");
+    printf("Transaction ID : %d\n", trans->transactionID);
+    if (bookIndex != -1) {
+        printf("Book           : %s\n", books[bookIndex].title);
+    }
+    if (memberIndex != -1) {
+        printf("Member         : %s\n", members[memberIndex].name);
+    }
+    printf("Return Date    : %s\n", returnStr);
+    
+    if (trans->fine > 0) {
+        printf("\n⚠ FINE: Rs. %.2f\n", trans->fine);
+        printf("  (Late by %d days)\n", 
+               getDaysDifference(trans->dueDate, trans->returnDate));
+    } else {
+        printf("\n✓ Returned on time. No fine!\n");
+    }
+    
+    if (reservedHold != -1) {
+        char expiryStr[12];
+        formatDate(holds[reservedHold].expiryDate, expiryStr);
+        printf("\n⚑ Copy reserved for member %d (hold %d) until %s\n",
+               holds[reservedHold].memberID, holds[reservedHold].holdID, expiryStr);
+        printf("  Place it on the hold shelf.\n");
+    }
+    
+    pauseScreen();
+}
+
+void deskMode() {
+    printHeader("DESK MODE");
+    
+    printf("Scan a member card, then book or copy barcodes. A copy that is on\n");
+    printf("loan is returned, any other copy is issued to the member. A book ID\n");
+    printf("returns the member's loan of it, or issues any free copy.\n");
+    printf("Labels carry a prefix: M member, B book, C copy (e.g. M2001, C100101).\n");
+    printf("Enter a blank line to leave.\n\n");
+    
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+    
+    int memberIndex = -1;
+    char line[MAX_STRING];
+    
+    while (1) {
+        sharedRelease();
+        printf("%s> ", memberIndex != -1 ? members[memberIndex].name : "scan");
+        fflush(stdout);
+        if (fgets(line, sizeof(line), stdin) == NULL) break;
+        
+        char prefix = (char)toupper((unsigned char)line[0]);
+        int id = atoi(isalpha((unsigned char)prefix) ? line + 1 : line);
+        if (id <= 0) break;
+        time_t now = libraryNow();
+        
+        int memberID = memberIndex != -1 ? members[memberIndex].memberID : 0;
+        sharedBegin();
+        if (memberID != 0) memberIndex = findMemberSlot(memberID);
+        
+        int copy = -1;
+        int member = prefix == 'M' || !isalpha((unsigned char)prefix) ? findMemberSlot(id) : -1;
+        int book = prefix == 'B' || !isalpha((unsigned char)prefix) ? findBookSlot(id) : -1;
+        int copySlot = prefix == 'C' || !isalpha((unsigned char)prefix) ? findCopy(id, &copy) : -1;
+        if (member != -1 && !members[member].isActive) member = -1;
+        if (book != -1 && !books[book].isActive) book = -1;
+        if (copySlot != -1 && !books[copySlot].isActive) copySlot = -1;
+        
+        if ((member != -1) + (book != -1) + (copySlot != -1) > 1) {
+            printf("  ✗ Barcode %d is ambiguous, scan it as M%d, B%d or C%d\n", id, id, id, id);
+            continue;
+        }
+        if (member != -1) {
+            memberIndex = member;
+            printf("  %s (ID: %d) - %d book(s) on loan, fines Rs. %.2f\n",
+                   members[member].name, id, members[member].booksIssued,
+                   members[member].totalFines + accruedFinesForMember(id, now));
+            continue;
+        }
+        
+        int slot = book != -1 ? book : copySlot;
+        if (slot == -1) {
+            printf("  ✗ Unknown barcode %d\n", id);
+            continue;
+        }
+        if (book != -1) copy = -1;
+        
+        int transIndex = copy == -1 ? findOpenLoan(id, memberID)
+                       : copyRows[slot].items[copy].status == COPY_ON_LOAN
+                       ? copyRows[slot].items[copy].loan : -1;
+        
+        if (transIndex != -1) {
+            int reservedHold = performReturn(transIndex, now);
+            printf("  ✓ Returned %s", books[slot].title);
+            if (transactions[transIndex].fine > 0) {
+                printf(" - FINE Rs. %.2f", transactions[transIndex].fine);
+            }
+            printf("\n");
+            if (reservedHold != -1) {
+                printf("  ⚑ Hold shelf: reserved for member %d\n", holds[reservedHold].memberID);
+            }
+        } else if (memberIndex == -1) {
+            printf("  ✗ %s: scan the member card first\n", books[slot].title);
+        } else {
+            transIndex = performIssue(slot, memberIndex, copy, now);
+            if (transIndex >= 0) {
+                char dueStr[12];
+                formatDate(transactions[transIndex].dueDate, dueStr);
+                printf("  ✓ Issued %s (copy %d), due %s\n", books[slot].title,
+                       transactions[transIndex].copyBarcode, dueStr);
+            } else if (transIndex == ISSUE_UNAVAILABLE) {
+                printf("  ✗ %s: %s\n", books[slot].title, copy == -1 ? "no copy available"
+                       : "copy is not on the shelf");
+            } else if (transIndex == ISSUE_LIMIT_REACHED) {
+                printf("  ✗ Member already has %d books\n", loanLimits[members[memberIndex].tier]);
+            } else {
+                printf("  ✗ Transaction limit reached\n");
+            }
+        }
+    }
+}
+
+int renderIssuedBooks(time_t now) {
+    if (renderMode == RENDER_TSV) {
+        renderf("transaction\tbook\tcopy\ttitle\tmember\tname\tissued\tdue\toverdue_days\n");
+    } else {
+        renderf("%-8s %-30s %-20s %-12s %-12s\n",
+                "Trans ID", "Book Title", "Member Name", "Issue Date", "Due Date");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    int issuedCount = 0;
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].isReturned) continue;
+        
+        const char *bookTitle = bookTitleFor(transactions[i].bookID);
+        const char *memberName = memberNameFor(transactions[i].memberID);
+        
+        char issueStr[12], dueStr[12];
+        formatDate(transactions[i].issueDate, issueStr);
+        formatDate(transactions[i].dueDate, dueStr);
+        
+        int daysOverdue = 0;
+        if (now > transactions[i].dueDate) {
+            daysOverdue = getDaysDifference(transactions[i].dueDate, now);
+        }
+        
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%d\t%d\t%s\t%d\t%s\t%s\t%s\t%d\n",
+                    transactions[i].transactionID, transactions[i].bookID,
+                    transactions[i].copyBarcode, bookTitle,
+                    transactions[i].memberID, memberName, issueStr, dueStr, daysOverdue);
+        } else if (now > transactions[i].dueDate) {
+            renderf("%-8d %-30s %-20s %-12s %-12s ⚠ OVERDUE (%d days)\n",
+                    transactions[i].transactionID, bookTitle, memberName,
+                    issueStr, dueStr, daysOverdue);
+        } else {
+            renderf("%-8d %-30s %-20s %-12s %-12s\n",
+                    transactions[i].transactionID, bookTitle, memberName,
+                    issueStr, dueStr);
+        }
+        issuedCount++;
+    }
+    
+    return issuedCount;
+}
+
+void viewIssuedBooks() {
+    printHeader("CURRENTLY ISSUED BOOKS");
+    
+    renderBegin(stdout, RENDER_TABLE);
+    int issuedCount = renderIssuedBooks(libraryNow());
+    renderEnd();
+    
+    printf("\nTotal Issued Books: %d\n", issuedCount);
+    pauseScreen();
+}
+
+int renderMemberHistory(int memberID) {
+    if (renderMode == RENDER_TSV) {
+        renderf("transaction\tbook\ttitle\tissued\treturned\tstatus\tfine\n");
+    } else {
+        renderf("%-8s %-30s %-12s %-12s %-10s %-10s\n",
+                "Trans ID", "Book", "Issue Date", "Return Date", "Status", "Fine");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    int count = 0;
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].memberID != memberID) continue;
+        
+        const char *bookTitle = bookTitleFor(transactions[i].bookID);
+        
+        char issueStr[12], returnStr[12];
+        formatDate(transactions[i].issueDate, issueStr);
+        
+        if (transactions[i].isReturned) {
+            formatDate(transactions[i].returnDate, returnStr);
+        } else {
+            strcpy(returnStr, renderMode == RENDER_TSV ? "" : "Not Yet");
+        }
+        
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%d\t%s\t%s\t%s\t%s\t%.2f\n",
+                    transactions[i].transactionID, transactions[i].bookID, bookTitle,
+                    issueStr, returnStr,
+                    transactions[i].isReturned ? "returned" : "issued",
+                    transactions[i].fine);
+        } else {
+            renderf("%-8d %-30s %-12s %-12s %-10s Rs. %.2f\n",
+                    transactions[i].transactionID, bookTitle, issueStr, returnStr,
+                    transactions[i].isReturned ? "Returned" : "Issued",
+                    transactions[i].fine);
+        }
+        count++;
+    }
+    
+    return count;
+}
+
+void viewMemberHistory(int memberID) {
+    printHeader("MEMBER TRANSACTION HISTORY");
+    
+    printf("Member ID: %d\n\n", memberID);
+    
+    renderBegin(stdout, RENDER_TABLE);
+    int count = renderMemberHistory(memberID);
+    renderEnd();
+    
+    if (count == 0) {
+        printf("No transaction history found.\n");
+    }
+    
+    pauseScreen();
+}
+
+int renderMemberLoans(int memberID, time_t now) {
+    renderf("%-30s %-12s %-12s %-8s\n",
+            "Book Title", "Issue Date", "Due Date", "Status");
+    renderf("────────────────────────────────────────────────────────────────\n");
+    
+    int count = 0;
+    for (int i = 0; i < transactionCount; i++) {
+        if (transactions[i].memberID != memberID || transactions[i].isReturned) continue;
+        
+        const char *bookTitle = bookTitleFor(transactions[i].bookID);
+        
+        char issueStr[12], dueStr[12];
+        formatDate(transactions[i].issueDate, issueStr);
+        formatDate(transactions[i].dueDate, dueStr);
+        
+        if (now > transactions[i].dueDate) {
+            int daysOverdue = getDaysDifference(transactions[i].dueDate, now);
+            renderf("%-30s %-12s %-12s ⚠ OVERDUE (%d days, Rs. %.2f)\n",
+                    bookTitle, issueStr, dueStr, daysOverdue,
+                    fineForDaysLate(transactionPolicy(&transactions[i]), daysOverdue));
+        } else {
+            renderf("%-30s %-12s %-12s ✓ Active\n", bookTitle, issueStr, dueStr);
+        }
+        count++;
+    }
+    
+    return count;
+}
+
+int compareLoanDeltas(const void *a, const void *b) {
+    const LoanDelta *x = (const LoanDelta *)a;
+    const LoanDelta *y = (const LoanDelta *)b;
+    if (x->when != y->when) return x->when < y->when ? -1 : 1;
+    if (x->transIndex != y->transIndex) return x->transIndex - y->transIndex;
+    return y->opens - x->opens;
+}
+
+LoanList *loanList(LoanList *table, int id, int insert) {
+    unsigned int h = ((unsigned int)id * 2654435761u) & (LOAN_LIST_HASH_SIZE - 1);
+    while (table[h].id != 0 && table[h].id != id) {
+        h = (h + 1) & (LOAN_LIST_HASH_SIZE - 1);
+    }
+    if (table[h].id == 0) {
+        if (!insert) return NULL;
+        table[h].id = id;
+        table[h].head = -1;
+        table[h].tail = -1;
+        table[h].length = 0;
+    }
+    return &table[h];
+}
+
+void linkLoanDelta(LoanList *table, int *next, int id, int delta) {
+    LoanList *list = loanList(table, id, 1);
+    next[delta] = -1;
+    if (list->tail == -1) {
+        list->head = delta;
+    } else {
+        next[list->tail] = delta;
+    }
+    list->tail = delta;
+    list->length++;
+}
+
+void appendLoanDelta(int transIndex, int opens, time_t when) {
+    LoanDelta *delta = &loanDeltas[loanDeltaCount++];
+    delta->when = when;
+    delta->transIndex = transIndex;
+    delta->opens = opens;
+    linkLoanDelta(bookLoanLists, bookDeltaNext, transactions[transIndex].bookID, loanDeltaCount - 1);
+    linkLoanDelta(memberLoanLists, memberDeltaNext, transactions[transIndex].memberID, loanDeltaCount - 1);
+    
+    if (opens) {
+        openLoanPosition[transIndex] = openLoanCount;
+        openLoanSet[openLoanCount++] = transIndex;
+    } else {
+        int position = openLoanPosition[transIndex];
+        int last = openLoanSet[--openLoanCount];
+        openLoanSet[position] = last;
+        openLoanPosition[last] = position;
+    }
+    
+    if (loanDeltaCount % LOAN_CHECKPOINT_SPAN == 0) {
+        int k = loanDeltaCount / LOAN_CHECKPOINT_SPAN;
+        memcpy(&loanCheckpointPool[loanCheckpointStart[k]], openLoanSet,
+               openLoanCount * sizeof(int));
+        loanCheckpointStart[k + 1] = loanCheckpointStart[k] + openLoanCount;
+    }
+}
+
+void recordLoanDelta(int transIndex, int opens, time_t when) {
+    if (loanDeltaCount > 0 && when < loanDeltas[loanDeltaCount - 1].when) {
+        temporalDirty = 1;
+    }
+    if (!temporalDirty) {
+        appendLoanDelta(transIndex, opens, when);
+    }
+}
+
+void rebuildTemporalIndex() {
+    static LoanDelta sorted[MAX_LOAN_DELTAS];
+    int n = 0;
+    
+    for (int i = 0; i < transactionCount; i++) {
+        sorted[n].when = transactions[i].issueDate;
+        sorted[n].transIndex = i;
+        sorted[n++].opens = 1;
+        if (transactions[i].isReturned) {
+            sorted[n].when = transactions[i].returnDate;
+            sorted[n].transIndex = i;
+            sorted[n++].opens = 0;
+        }
+    }
+    qsort(sorted, n, sizeof(LoanDelta), compareLoanDeltas);
+    
+    loanDeltaCount = 0;
+    openLoanCount = 0;
+    memset(bookLoanLists, 0, sizeof(bookLoanLists));
+    memset(memberLoanLists, 0, sizeof(memberLoanLists));
+    loanCheckpointStart[0] = 0;
+    loanCheckpointStart[1] = 0;
+    for (int i = 0; i < n; i++) {
+        appendLoanDelta(sorted[i].transIndex, sorted[i].opens, sorted[i].when);
+    }
+    temporalDirty = 0;
+}
+
+int loansDuring(time_t from, time_t to, int bookID, int memberID, int *out) {
+    static unsigned char open[MAX_TRANSACTIONS];
+    if (temporalDirty) rebuildTemporalIndex();
+    
+    if (bookID != 0 || memberID != 0) {
+        LoanList *bookList = bookID != 0 ? loanList(bookLoanLists, bookID, 0) : NULL;
+        LoanList *memberList = memberID != 0 ? loanList(memberLoanLists, memberID, 0) : NULL;
+        if ((bookID != 0 && bookList == NULL) || (memberID != 0 && memberList == NULL)) return 0;
+        
+        int useBooks = memberList == NULL || (bookList != NULL && bookList->length <= memberList->length);
+        int *next = useBooks ? bookDeltaNext : memberDeltaNext;
+        int head = useBooks ? bookList->head : memberList->head;
+        
+        int d = head;
+        for (; d != -1 && loanDeltas[d].when <= from; d = next[d]) {
+            open[loanDeltas[d].transIndex] = (unsigned char)loanDeltas[d].opens;
+        }
+        int later = d;
+        
+        int count = 0;
+        for (d = head; d != later; d = next[d]) {
+            int t = loanDeltas[d].transIndex;
+            if (!open[t]) continue;
+            open[t] = 0;
+            out[count] = t;
+            count += (bookID == 0 || transactions[t].bookID == bookID) &&
+                     (memberID == 0 || transactions[t].memberID == memberID);
+        }
+        for (d = later; d != -1 && loanDeltas[d].when < to; d = next[d]) {
+            int t = loanDeltas[d].transIndex;
+            if (!loanDeltas[d].opens) continue;
+            out[count] = t;
+            count += (bookID == 0 || transactions[t].bookID == bookID) &&
+                     (memberID == 0 || transactions[t].memberID == memberID);
+        }
+        return count;
+    }
+    
+    int low = 0, high = loanDeltaCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (loanDeltas[mid].when <= from) low = mid + 1;
+        else high = mid;
+    }
+    
+    int k = low / LOAN_CHECKPOINT_SPAN;
+    int first = loanCheckpointStart[k], last = loanCheckpointStart[k + 1];
+    int replay = k * LOAN_CHECKPOINT_SPAN;
+    
+    for (int i = first; i < last; i++) {
+        open[loanCheckpointPool[i]] = 1;
+    }
+    for (int i = replay; i < low; i++) {
+        open[loanDeltas[i].transIndex] = (unsigned char)loanDeltas[i].opens;
+    }
+    
+    int count = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        int start = pass == 0 ? first : replay;
+        int end = pass == 0 ? last : low;
+        for (int i = start; i < end; i++) {
+            int t = pass == 0 ? loanCheckpointPool[i] : loanDeltas[i].transIndex;
+            if (!open[t]) continue;
+            open[t] = 0;
+            out[count] = t;
+            count += (bookID == 0 || transactions[t].bookID == bookID) &&
+                     (memberID == 0 || transactions[t].memberID == memberID);
+        }
+    }
+    
+    for (int i = low; i < loanDeltaCount && loanDeltas[i].when < to; i++) {
+        int t = loanDeltas[i].transIndex;
+        if (!loanDeltas[i].opens) continue;
+        out[count] = t;
+        count += (bookID == 0 || transactions[t].bookID == bookID) &&
+                 (memberID == 0 || transactions[t].memberID == memberID);
+    }
+    
+    return count;
+}
+
+int compareInts(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+int renderLoansDuring(time_t from, time_t to, int bookID, int memberID) {
+    static int loans[MAX_TRANSACTIONS];
+    int count = loansDuring(from, to, bookID, memberID, loans);
+    qsort(loans, count, sizeof(int), compareInts);
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("transaction\tbook\ttitle\tmember\tname\tissued\treturned\n");
+    } else {
+        renderf("%-8s %-30s %-20s %-12s %-12s\n",
+                "Trans ID", "Book Title", "Member Name", "Issue Date", "Return Date");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < count; i++) {
+        Transaction *trans = &transactions[loans[i]];
+        const char *bookTitle = bookTitleFor(trans->bookID);
+        const char *memberName = memberNameFor(trans->memberID);
+        
+        char issueStr[12], returnStr[12];
+        formatDate(trans->issueDate, issueStr);
+        if (trans->isReturned) {
+            formatDate(trans->returnDate, returnStr);
+        } else {
+            strcpy(returnStr, renderMode == RENDER_TSV ? "" : "On loan");
+        }
+        
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%d\t%s\t%d\t%s\t%s\t%s\n",
+                    trans->transactionID, trans->bookID, bookTitle,
+                    trans->memberID, memberName, issueStr, returnStr);
+        } else {
+            renderf("%-8d %-30s %-20s %-12s %-12s\n",
+                    trans->transactionID, bookTitle, memberName, issueStr, returnStr);
+        }
+    }
+    
+    return count;
+}
+
+void loansOnDateReport() {
+    printHeader("LOANS ON DATE / PERIOD");
+    
+    char fromText[MAX_STRING], toText[MAX_STRING];
+    int bookID, memberID;
+    
+    printf("From date (YYYY-MM-DD): ");
+    scanf(" %[^\n]", fromText);
+    printf("To date (YYYY-MM-DD, or 'same'): ");
+    scanf(" %[^\n]", toText);
+    printf("Book ID (0 for all): ");
+    scanf("%d", &bookID);
+    printf("Member ID (0 for all): ");
+    scanf("%d", &memberID);
+    
+    time_t from = parseDate(fromText);
+    time_t to = strcmp(toText, "same") == 0 ? from : parseDate(toText);
+    if (from == (time_t)-1 || to == (time_t)-1 || to < from) {
+        printf("\n✗ Invalid date!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\n");
+    renderBegin(stdout, RENDER_TABLE);
+    int count = renderLoansDuring(from - SECONDS_PER_DAY + 1, to + 1, bookID, memberID);
+    renderEnd();
+    
+    printf("\nLoans: %d\n", count);
+    pauseScreen();
+}
+
+void transactionMenu() {
+    while (1) {
+        printHeader("TRANSACTION MANAGEMENT");
+        
+        printf("1. Issue Book\n");
+        printf("2. Return Book\n");
+        printf("3. View Currently Issued Books\n");
+        printf("4. View Member History\n");
+        printf("5. Place Hold\n");
+        printf("6. View Hold Queue\n");
+        printf("7. Desk Mode (scan to issue/return)\n");
+        printf("8. Send Due-Date Reminders\n");
+        printf("9. Back to Main Menu\n");
+        printf("\nChoice: ");
+        
+        int choice;
+        scanf("%d", &choice);
+        
+        switch (choice) {
+            case 1: issueBook(); break;
+            case 2: returnBook(); break;
+            case 3: viewIssuedBooks(); break;
+            case 4: {
+                int memberID;
+                printf("\nEnter Member ID: ");
+                scanf("%d", &memberID);
+                viewMemberHistory(memberID);
+                break;
+            }
+            case 5: {
+                int memberID;
+                printf("\nEnter Member ID: ");
+                scanf("%d", &memberID);
+                placeHoldMenu(memberID);
+                break;
+            }
+            case 6: viewHoldQueue(); break;
+            case 7: deskMode(); break;
+            case 8: sendRemindersMenu(); break;
+            case 9: return;
+            default:
+                printf("\n✗ Invalid choice!\n");
+                pauseScreen();
+        }
+    }
+}
+
+unsigned int hashFolded(const char *str) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; str[i]; i++) {
+        hash ^= (unsigned char)tolower((unsigned char)str[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void sketchAdd(SketchEntry *entries, int *size, int capacity,
+               int key, int labelID, int weight) {
+    int minIndex = 0;
+    for (int i = 0; i < *size; i++) {
+        if (entries[i].key == key) {
+            entries[i].count += weight;
+            return;
+        }
+        if (entries[i].count < entries[minIndex].count) {
+            minIndex = i;
+        }
+    }
+    
+    if (*size < capacity) {
+        SketchEntry entry = {key, labelID, weight, 0};
+        entries[(*size)++] = entry;
+        return;
+    }
+    
+    entries[minIndex].error = entries[minIndex].count;
+    entries[minIndex].count += weight;
+    entries[minIndex].key = key;
+    entries[minIndex].labelID = labelID;
+}
+
+AnalyticsPane *analyticsPane(time_t when) {
+    long day = (long)(when / SECONDS_PER_DAY);
+    AnalyticsPane *pane = &analytics.panes[day % ANALYTICS_DAYS];
+    if (pane->day != day) {
+        memset(pane, 0, sizeof(AnalyticsPane));
+        pane->day = day;
+    }
+    return pane;
+}
+
+void recordIssueAnalytics(int bookIndex, int memberIndex, time_t when) {
+    AnalyticsPane *pane = analyticsPane(when);
+    
+    analytics.bookBorrows[bookIndex]++;
+    analytics.memberBorrows[memberIndex]++;
+    bumpSuggestion(SUGGEST_TITLE, books[bookIndex].title);
+    bumpSuggestion(SUGGEST_AUTHOR, books[bookIndex].author);
+    bumpSuggestion(SUGGEST_MEMBER, members[memberIndex].name);
+    sketchAdd(pane->entries[METRIC_TITLES], &pane->sizes[METRIC_TITLES], PANE_SLOTS,
+              books[bookIndex].bookID, books[bookIndex].bookID, 1);
+    sketchAdd(pane->entries[METRIC_MEMBERS], &pane->sizes[METRIC_MEMBERS], PANE_SLOTS,
+              members[memberIndex].memberID, members[memberIndex].memberID, 1);
+}
+
+void recordOverdueAnalytics(int bookIndex, time_t when) {
+    AnalyticsPane *pane = analyticsPane(when);
+    int key = (int)hashFolded(books[bookIndex].author);
+    
+    sketchAdd(analytics.authorOverdue, &analytics.authorSize, AUTHOR_SKETCH_SLOTS,
+              key, books[bookIndex].bookID, 1);
+    sketchAdd(pane->entries[METRIC_AUTHORS], &pane->sizes[METRIC_AUTHORS], PANE_SLOTS,
+              key, books[bookIndex].bookID, 1);
+}
+
+void recordCoBorrows(int bookIndex, int memberIndex, int save) {
+    int bookID = books[bookIndex].bookID;
+    int *recent = analytics.recentBorrows[memberIndex];
+    int seen = analytics.memberBorrows[memberIndex] - 1;
+    if (seen > RECENT_BORROWS) seen = RECENT_BORROWS;
+    
+    for (int i = 0; i < seen; i++) {
+        int other = recent[i];
+        if (other == bookID) continue;
+        
+        sketchAdd(analytics.neighbours[bookIndex], &analytics.neighbourSize[bookIndex],
+                  NEIGHBOUR_SLOTS, other, other, 1);
+        int otherIndex = findBookSlot(other);
+        if (otherIndex == -1) continue;
+        sketchAdd(analytics.neighbours[otherIndex], &analytics.neighbourSize[otherIndex],
+                  NEIGHBOUR_SLOTS, bookID, bookID, 1);
+        if (save) {
+            saveAnalyticsRange(analytics.neighbours[otherIndex], sizeof(analytics.neighbours[0]));
+            saveAnalyticsRange(&analytics.neighbourSize[otherIndex], sizeof(int));
+        }
+    }
+    recent[(analytics.memberBorrows[memberIndex] - 1) % RECENT_BORROWS] = bookID;
+    
+    if (++analytics.coBorrowLoans % CO_BORROW_DECAY_LOANS == 0) {
+        decayCoBorrows();
+        if (save) {
+            saveAnalyticsRange(analytics.neighbours, sizeof(analytics.neighbours) +
+                               sizeof(analytics.neighbourSize));
+        }
+    }
+    
+    if (save) {
+        saveAnalyticsRange(analytics.neighbours[bookIndex], sizeof(analytics.neighbours[0]));
+        saveAnalyticsRange(&analytics.neighbourSize[bookIndex], sizeof(int));
+        saveAnalyticsRange(analytics.recentBorrows[memberIndex], sizeof(analytics.recentBorrows[0]));
+        saveAnalyticsRange(&analytics.coBorrowLoans, sizeof(int));
+    }
+}
+
+void decayCoBorrows() {
+    for (int b = 0; b < bookCount; b++) {
+        SketchEntry *entries = analytics.neighbours[b];
+        int kept = 0;
+        for (int i = 0; i < analytics.neighbourSize[b]; i++) {
+            entries[i].count >>= 1;
+            entries[i].error >>= 1;
+            if (entries[i].count > 0) entries[kept++] = entries[i];
+        }
+        analytics.neighbourSize[b] = kept;
+    }
+}
+
+int recommendBooks(int bookIndex, int memberIndex, int *out, int limit) {
+    SketchEntry ranked[NEIGHBOUR_SLOTS];
+    int size = analytics.neighbourSize[bookIndex];
+    memcpy(ranked, analytics.neighbours[bookIndex], size * sizeof(SketchEntry));
+    
+    int count = 0;
+    for (int i = 0; i < size && count < limit; i++) {
+        int best = i;
+        for (int j = i + 1; j < size; j++) {
+            if (ranked[j].count - ranked[j].error > ranked[best].count - ranked[best].error) best = j;
+        }
+        SketchEntry temp = ranked[i];
+        ranked[i] = ranked[best];
+        ranked[best] = temp;
+        
+        int slot = findBookSlot(ranked[i].key);
+        if (slot == -1 || !books[slot].isActive) continue;
+        
+        int borrowed = 0;
+        if (memberIndex != -1) {
+            int seen = analytics.memberBorrows[memberIndex];
+            if (seen > RECENT_BORROWS) seen = RECENT_BORROWS;
+            for (int r = 0; r < seen; r++) {
+                borrowed |= analytics.recentBorrows[memberIndex][r] == ranked[i].key;
+            }
+        }
+        if (!borrowed) out[count++] = slot;
+    }
+    return count;
+}
+
+int renderRecommendations(int bookIndex, int memberIndex, int limit) {
+    int slots[NEIGHBOUR_SLOTS];
+    if (limit > NEIGHBOUR_SLOTS) limit = NEIGHBOUR_SLOTS;
+    int count = recommendBooks(bookIndex, memberIndex, slots, limit);
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("id\ttitle\tauthor\tavailable\n");
+    } else if (count > 0) {
+        renderf("Borrowed together with %s:\n", books[bookIndex].title);
+    }
+    
+    for (int i = 0; i < count; i++) {
+        Book *book = &books[slots[i]];
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%s\t%d\n", book->bookID, book->title, book->author,
+                    book->availableCopies);
+        } else {
+            renderf("  • %-30s %-20s (ID: %d, %d available)\n",
+                    book->title, book->author, book->bookID, book->availableCopies);
+        }
+    }
+    return count;
+}
+
+void rebuildAnalytics() {
+    memset(&analytics, 0, sizeof(analytics));
+    for (int d = 0; d < ANALYTICS_DAYS; d++) {
+        analytics.panes[d].day = -1;
+    }
+    
+    time_t oldest = libraryNow() - (time_t)ANALYTICS_DAYS * SECONDS_PER_DAY;
+    for (int i = 0; i < transactionCount; i++) {
+        int bookIndex = findBookSlot(transactions[i].bookID);
+        int memberIndex = findMemberSlot(transactions[i].memberID);
+        if (bookIndex == -1 || memberIndex == -1) continue;
+        
+        if (transactions[i].issueDate > oldest) {
+            recordIssueAnalytics(bookIndex, memberIndex, transactions[i].issueDate);
+        } else {
+            analytics.bookBorrows[bookIndex]++;
+            analytics.memberBorrows[memberIndex]++;
+        }
+        recordCoBorrows(bookIndex, memberIndex, 0);
+        
+        if (transactions[i].isReturned && transactions[i].fine > 0) {
+            if (transactions[i].returnDate > oldest) {
+                recordOverdueAnalytics(bookIndex, transactions[i].returnDate);
+            } else {
+                sketchAdd(analytics.authorOverdue, &analytics.authorSize,
+                          AUTHOR_SKETCH_SLOTS, (int)hashFolded(books[bookIndex].author),
+                          books[bookIndex].bookID, 1);
+            }
+        }
+    }
+}
+
+void loadAnalytics() {
+    FILE *file = fopen(dataPath(ANALYTICS_FILE), "rb");
+    if (file == NULL) {
+        rebuildAnalytics();
+        saveAnalytics();
+        return;
+    }
+    
+    if (fread(&analytics, sizeof(Analytics), 1, file) != 1) {
+        fclose(file);
+        rebuildAnalytics();
+        saveAnalytics();
+        return;
+    }
+    fclose(file);
+}
+
+void saveAnalytics() {
+    markSharedRange(SHARED_ANALYTICS, &analytics, sizeof(Analytics));
+    FILE *file = fopen(dataPath(ANALYTICS_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving analytics!\n");
+        return;
+    }
+    
+    fwrite(&analytics, sizeof(Analytics), 1, file);
+    fclose(file);
+}
+
+void saveAnalyticsRange(const void *field, size_t size) {
+    markSharedRange(SHARED_ANALYTICS, field, size);
+    FILE *file = fopen(dataPath(ANALYTICS_FILE), "r+b");
+    if (file == NULL) {
+        saveAnalytics();
+        return;
+    }
+    
+    fseek(file, (long)((const char *)field - (const char *)&analytics), SEEK_SET);
+    fwrite(field, 1, size, file);
+    fclose(file);
+}
+
+int topN(int metric, int days, time_t now, SketchEntry *out, int limit) {
+    static SketchEntry merged[MERGE_TABLE_SIZE];
+    static int used[MERGE_TABLE_SIZE];
+    int usedCount = 0;
+    
+    if (days <= 0) {
+        if (metric == METRIC_AUTHORS) {
+            memcpy(merged, analytics.authorOverdue, sizeof(analytics.authorOverdue));
+            usedCount = analytics.authorSize;
+        } else {
+            int count = metric == METRIC_TITLES ? bookCount : memberCount;
+            for (int i = 0; i < count; i++) {
+                int borrows = metric == METRIC_TITLES ? analytics.bookBorrows[i]
+                                                      : analytics.memberBorrows[i];
+                if (borrows == 0) continue;
+                int id = metric == METRIC_TITLES ? books[i].bookID : members[i].memberID;
+                SketchEntry entry = {id, id, borrows, 0};
+                merged[usedCount++] = entry;
+            }
+        }
+    } else {
+        memset(used, 0, sizeof(used));
+        long today = (long)(now / SECONDS_PER_DAY);
+        int distinct = 0;
+        
+        for (long day = today - days + 1; day <= today; day++) {
+            AnalyticsPane *pane = &analytics.panes[day % ANALYTICS_DAYS];
+            if (pane->day != day) continue;
+            
+            for (int i = 0; i < pane->sizes[metric]; i++) {
+                SketchEntry *entry = &pane->entries[metric][i];
+                unsigned int h = (unsigned int)entry->key & (MERGE_TABLE_SIZE - 1);
+                while (used[h] && merged[h].key != entry->key) {
+                    h = (h + 1) & (MERGE_TABLE_SIZE - 1);
+                }
+                if (!used[h]) {
+                    used[h] = 1;
+                    merged[h] = *entry;
+                    distinct++;
+                } else {
+                    merged[h].count += entry->count;
+                    merged[h].error += entry->error;
+                }
+            }
+        }
+        
+        for (int h = 0; h < MERGE_TABLE_SIZE && usedCount < distinct; h++) {
+            if (used[h]) {
+                merged[usedCount++] = merged[h];
+            }
+        }
+    }
+    
+    int found = 0;
+    for (; found < limit && found < usedCount; found++) {
+        int best = found;
+        for (int i = found + 1; i < usedCount; i++) {
+            if (merged[i].count > merged[best].count) {
+                best = i;
+            }
+        }
+        SketchEntry temp = merged[found];
+        merged[found] = merged[best];
+        merged[best] = temp;
+        out[found] = merged[found];
+    }
+    
+    return found;
+}
+
+int renderTopN(int metric, int days, int limit) {
+    SketchEntry top[TOP_N * 10];
+    if (limit > TOP_N * 10) limit = TOP_N * 10;
+    
+    int count = topN(metric, days, libraryNow(), top, limit);
+    const char *heading = metric == METRIC_TITLES ? "Title"
+                        : metric == METRIC_MEMBERS ? "Member" : "Author";
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("rank\tid\t%s\tcount\terror\n", metric == METRIC_AUTHORS ? "author"
+                : metric == METRIC_TITLES ? "title" : "name");
+    } else {
+        renderf("%-6s %-8s %-40s %-8s\n", "Rank", "ID", heading, "Count");
+        renderf("────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < count; i++) {
+        const char *label = "Unknown";
+        if (metric == METRIC_MEMBERS) {
+            label = memberNameFor(top[i].labelID);
+        } else {
+            const Book *book = bookRecord(top[i].labelID);
+            if (book != NULL) {
+                label = metric == METRIC_TITLES ? book->title : book->author;
+            }
+        }
+        
+        int id = metric == METRIC_AUTHORS ? top[i].labelID : top[i].key;
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%d\t%s\t%d\t%d\n", i + 1, id, label, top[i].count, top[i].error);
+        } else if (top[i].error > 0) {
+            renderf("%-6d %-8d %-40s %d (±%d)\n", i + 1, id, label,
+                    top[i].count, top[i].error);
+        } else {
+            renderf("%-6d %-8d %-40s %d\n", i + 1, id, label, top[i].count);
+        }
+    }
+    
+    return count;
+}
+
+void popularityReport() {
+    printHeader("POPULARITY ANALYTICS");
+    
+    printf("Time Window:\n");
+    printf("1. Last 7 days\n");
+    printf("2. Last 30 days\n");
+    printf("3. Last 365 days\n");
+    printf("4. All time\n");
+    printf("\nChoice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    
+    int windows[] = {7, 30, 365, 0};
+    if (choice < 1 || choice > 4) {
+        printf("\n✗ Invalid choice!\n");
+        pauseScreen();
+        return;
+    }
+    int days = windows[choice - 1];
+    
+    renderBegin(stdout, RENDER_TABLE);
+    renderf("\nMost Borrowed Titles\n");
+    if (renderTopN(METRIC_TITLES, days, TOP_N) == 0) renderf("No data.\n");
+    renderf("\nMost Active Members\n");
+    if (renderTopN(METRIC_MEMBERS, days, TOP_N) == 0) renderf("No data.\n");
+    renderf("\nMost Overdue Authors\n");
+    if (renderTopN(METRIC_AUTHORS, days, TOP_N) == 0) renderf("No data.\n");
+    renderEnd();
+    
+    pauseScreen();
+}
+
+long civilDay(int year, int month, int mday) {
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + mday - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void civilDate(long day, int *year, int *month, int *mday) {
+    day += 719468;
+    long era = (day >= 0 ? day : day - 146096) / 146097;
+    long dayOfEra = day - era * 146097;
+    long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long monthIndex = (5 * dayOfYear + 2) / 153;
+    
+    *mday = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    *month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    *year = (int)(yearOfEra + era * 400 + (*month <= 2));
+}
+
+long circulationDay(time_t when) {
+    struct tm local = *localtime(&when);
+    return civilDay(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+int circulationCategory(const char *category, int create) {
+    char name[CATEGORY_LENGTH];
+    snprintf(name, sizeof(name), "%s", category[0] != '\0' ? category : "Uncategorized");
+    
+    for (int c = 0; c < circulation.categoryCount; c++) {
+        if (compareFolded(circulation.categories[c], name) == 0) return c;
+    }
+    if (!create) return -1;
+    
+    if (circulation.categoryCount >= MAX_CATEGORIES - 1) {
+        if (circulation.categoryCount == MAX_CATEGORIES - 1) {
+            strcpy(circulation.categories[MAX_CATEGORIES - 1], "Other");
+            circulation.categoryCount++;
+        }
+        return MAX_CATEGORIES - 1;
+    }
+    strcpy(circulation.categories[circulation.categoryCount], name);
+    return circulation.categoryCount++;
+}
+
+void addDayCounts(DayCounts *to, const DayCounts *delta, int sign) {
+    to->issues += sign * delta->issues;
+    to->returns += sign * delta->returns;
+    to->overdue += sign * delta->overdue;
+    to->fines += sign * delta->fines;
+}
+
+void buildCirculationTree() {
+    for (int s = 0; s < CIRCULATION_SERIES; s++) {
+        memset(&circulationTree[s][0], 0, sizeof(DayCounts));
+        memcpy(&circulationTree[s][1], circulation.days[s], sizeof(circulation.days[s]));
+        for (int i = 1; i <= CIRCULATION_DAYS; i++) {
+            int parent = i + (i & -i);
+            if (parent <= CIRCULATION_DAYS) {
+                addDayCounts(&circulationTree[s][parent], &circulationTree[s][i], 1);
+            }
+        }
+    }
+}
+
+void shiftCirculation(long day) {
+    long shift = day - circulation.baseDay - CIRCULATION_DAYS + 1;
+    if (shift < CIRCULATION_DAYS / 8) shift = CIRCULATION_DAYS / 8;
+    
+    for (int s = 0; s < CIRCULATION_SERIES; s++) {
+        if (shift >= CIRCULATION_DAYS) {
+            memset(circulation.days[s], 0, sizeof(circulation.days[s]));
+        } else {
+            memmove(circulation.days[s], circulation.days[s] + shift,
+                    (CIRCULATION_DAYS - shift) * sizeof(DayCounts));
+            memset(circulation.days[s] + CIRCULATION_DAYS - shift, 0,
+                   shift * sizeof(DayCounts));
+        }
+    }
+    circulation.baseDay += shift;
+    buildCirculationTree();
+}
+
+void recordCirculation(const char *category, time_t when, int issues, int returns,
+                       float fines, int save) {
+    long day = circulationDay(when);
+    if (day < circulation.baseDay) return;
+    
+    int shifted = day - circulation.baseDay >= CIRCULATION_DAYS;
+    if (shifted) shiftCirculation(day);
+    
+    int categoryCount = circulation.categoryCount;
+    int series[2] = {0, circulationCategory(category, 1) + 1};
+    int index = (int)(day - circulation.baseDay);
+    DayCounts delta = {issues, returns, fines > 0, fines};
+    
+    for (int k = 0; k < 2; k++) {
+        addDayCounts(&circulation.days[series[k]][index], &delta, 1);
+        for (int i = index + 1; i <= CIRCULATION_DAYS; i += i & -i) {
+            addDayCounts(&circulationTree[series[k]][i], &delta, 1);
+        }
+    }
+    
+    if (!save) return;
+    if (shifted) {
+        saveCirculation();
+        return;
+    }
+    if (categoryCount != circulation.categoryCount) {
+        saveCirculationRange(&circulation.categoryCount,
+                             sizeof(int) + sizeof(circulation.categories));
+    }
+    saveCirculationRange(&circulation.days[0][index], sizeof(DayCounts));
+    saveCirculationRange(&circulation.days[series[1]][index], sizeof(DayCounts));
+}
+
+DayCounts circulationPrefix(int series, int count) {
+    DayCounts sum = {0, 0, 0, 0};
+    for (int i = count; i > 0; i -= i & -i) {
+        addDayCounts(&sum, &circulationTree[series][i], 1);
+    }
+    return sum;
+}
+
+DayCounts circulationRange(int series, long fromDay, long toDay) {
+    long lo = fromDay - circulation.baseDay;
+    long hi = toDay - circulation.baseDay + 1;
+    if (lo < 0) lo = 0;
+    if (hi > CIRCULATION_DAYS) hi = CIRCULATION_DAYS;
+    
+    DayCounts sum = {0, 0, 0, 0};
+    if (hi <= lo) return sum;
+    
+    sum = circulationPrefix(series, (int)hi);
+    DayCounts before = circulationPrefix(series, (int)lo);
+    addDayCounts(&sum, &before, -1);
+    return sum;
+}
+
+void rebuildCirculation() {
+    memset(&circulation, 0, sizeof(circulation));
+    
+    circulation.baseDay = circulationDay(libraryNow());
+    for (int i = 0; i < transactionCount; i++) {
+        long day = circulationDay(transactions[i].issueDate);
+        if (day < circulation.baseDay) circulation.baseDay = day;
+    }
+    
+    for (int i = 0; i < transactionCount; i++) {
+        Transaction *trans = &transactions[i];
+        const Book *book = bookRecord(trans->bookID);
+        const char *category = book != NULL ? book->category : "";
+        
+        recordCirculation(category, trans->issueDate, 1, 0, 0, 0);
+        if (trans->isReturned) {
+            recordCirculation(category, trans->returnDate, 0, 1, trans->fine, 0);
+        }
+    }
+    buildCirculationTree();
+}
+
+void loadCirculation() {
+    FILE *file = fopen(dataPath(CIRCULATION_FILE), "rb");
+    if (file == NULL) {
+        rebuildCirculation();
+        saveCirculation();
+        return;
+    }
+    
+    if (fread(&circulation, sizeof(Circulation), 1, file) != 1) {
+        fclose(file);
+        rebuildCirculation();
+        saveCirculation();
+        return;
+    }
+    fclose(file);
+    buildCirculationTree();
+}
+
+void saveCirculation() {
+    markSharedRange(SHARED_CIRCULATION, &circulation, sizeof(Circulation));
+    FILE *file = fopen(dataPath(CIRCULATION_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving circulation counters!\n");
+        return;
+    }
+    
+    fwrite(&circulation, sizeof(Circulation), 1, file);
+    fclose(file);
+}
+
+void saveCirculationRange(const void *field, size_t size) {
+    markSharedRange(SHARED_CIRCULATION, field, size);
+    FILE *file = fopen(dataPath(CIRCULATION_FILE), "r+b");
+    if (file == NULL) {
+        saveCirculation();
+        return;
+    }
+    
+    fseek(file, (long)((const char *)field - (const char *)&circulation), SEEK_SET);
+    fwrite(field, 1, size, file);
+    fclose(file);
+}
+
+int parsePeriod(const char *name) {
+    for (int p = 0; p < PERIOD_COUNT; p++) {
+        if (strcmp(name, periodNames[p]) == 0) return p;
+    }
+    return -1;
+}
+
+int renderCirculation(int period, int count, long endDay, int category) {
+    static DayCounts sums[CIRCULATION_DAYS];
+    static long starts[CIRCULATION_DAYS];
+    if (count > CIRCULATION_DAYS) count = CIRCULATION_DAYS;
+    
+    int series = category + 1;
+    int year, month, mday;
+    civilDate(endDay, &year, &month, &mday);
+    
+    int peak = 0;
+    for (int i = 0; i < count; i++) {
+        int back = count - 1 - i;
+        long from, to;
+        if (period == PERIOD_DAILY) {
+            from = to = endDay - back;
+        } else if (period == PERIOD_WEEKLY) {
+            to = endDay - 7L * back;
+            from = to - 6;
+        } else {
+            int monthIndex = year * 12 + (month - 1) - back;
+            int y = monthIndex / 12, m = monthIndex % 12 + 1;
+            from = civilDay(y, m, 1);
+            to = civilDay(m == 12 ? y + 1 : y, m % 12 + 1, 1) - 1;
+            if (to > endDay) to = endDay;
+        }
+        
+        starts[i] = from;
+        sums[i] = circulationRange(series, from, to);
+        if (sums[i].issues > peak) peak = sums[i].issues;
+    }
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("period\tissues\treturns\toverdue\tfines\n");
+    } else {
+        renderf("%-12s %7s %7s %7s %10s  %s\n",
+                "Period", "Issues", "Returns", "Overdue", "Fines", "Issues chart");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < count; i++) {
+        char label[16];
+        civilDate(starts[i], &year, &month, &mday);
+        if (period == PERIOD_MONTHLY) {
+            snprintf(label, sizeof(label), "%04d-%02d", year, month);
+        } else {
+            snprintf(label, sizeof(label), "%04d-%02d-%02d", year, month, mday);
+        }
+        
+        if (renderMode == RENDER_TSV) {
+            renderf("%s\t%d\t%d\t%d\t%.2f\n", label, sums[i].issues,
+                    sums[i].returns, sums[i].overdue, sums[i].fines);
+            continue;
+        }
+        
+        char bar[CIRCULATION_BAR_WIDTH * 3 + 1];
+        int width = peak > 0 ? sums[i].issues * CIRCULATION_BAR_WIDTH / peak : 0;
+        if (width == 0 && sums[i].issues > 0) width = 1;
+        for (int b = 0; b < width; b++) memcpy(bar + b * 3, "█", 3);
+        bar[width * 3] = '\0';
+        
+        renderf("%-12s %7d %7d %7d %10.2f  %s\n", label, sums[i].issues,
+                sums[i].returns, sums[i].overdue, sums[i].fines, bar);
+    }
+    
+    if (renderMode != RENDER_TSV && count > 0) {
+        DayCounts total = circulationRange(series, starts[0], endDay);
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+        renderf("%-12s %7d %7d %7d %10.2f\n", "Total", total.issues,
+                total.returns, total.overdue, total.fines);
+    }
+    
+    return count;
+}
+
+void circulationReport() {
+    printHeader("CIRCULATION TRENDS");
+    
+    printf("Period:\n");
+    printf("1. Daily (last %d days)\n", periodDefaultCount[PERIOD_DAILY]);
+    printf("2. Weekly (last %d weeks)\n", periodDefaultCount[PERIOD_WEEKLY]);
+    printf("3. Monthly (last %d months)\n", periodDefaultCount[PERIOD_MONTHLY]);
+    printf("\nChoice: ");
+    
+    int period;
+    scanf("%d", &period);
+    if (period < 1 || period > PERIOD_COUNT) {
+        printf("\n✗ Invalid choice!\n");
+        pauseScreen();
+        return;
+    }
+    period--;
+    
+    printf("\nCategory:\n");
+    printf("0. All categories\n");
+    for (int c = 0; c < circulation.categoryCount; c++) {
+        printf("%d. %s\n", c + 1, circulation.categories[c]);
+    }
+    printf("\nChoice: ");
+    
+    int category;
+    scanf("%d", &category);
+    if (category < 0 || category > circulation.categoryCount) {
+        printf("\n✗ Invalid choice!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\n");
+    renderBegin(stdout, RENDER_TABLE);
+    renderCirculation(period, periodDefaultCount[period],
+                      circulationDay(libraryNow()), category - 1);
+    renderEnd();
+    
+    pauseScreen();
+}
+
+long long reminderTick(time_t when) {
+    return (long long)when / REMINDER_TICK;
+}
+
+void markReminder(int entry) {
+    if (entry == -1 || reminderMarked[entry]) return;
+    reminderMarked[entry] = 1;
+    reminderDirty[reminderDirtyCount++] = entry;
+}
+
+void clearReminderMarks() {
+    for (int i = 0; i < reminderDirtyCount; i++) {
+        reminderMarked[reminderDirty[i]] = 0;
+    }
+    reminderDirtyCount = 0;
+}
+
+void linkReminder(int entry, int bucket) {
+    Reminder *reminder = &reminders.entries[entry];
+    markReminder(entry);
+    markReminder(reminders.heads[bucket]);
+    reminder->bucket = bucket;
+    reminder->prev = -1;
+    reminder->next = reminders.heads[bucket];
+    if (reminder->next != -1) reminders.entries[reminder->next].prev = entry;
+    reminders.heads[bucket] = entry;
+    if (bucket < WHEEL_DUE) {
+        reminders.occupied[bucket / WHEEL_SLOTS] |= 1ULL << (bucket % WHEEL_SLOTS);
+    }
+}
+
+void unlinkReminder(int entry) {
+    Reminder *reminder = &reminders.entries[entry];
+    int bucket = reminder->bucket;
+    if (bucket == -1) return;
+    
+    markReminder(entry);
+    markReminder(reminder->prev);
+    markReminder(reminder->next);
+    if (reminder->prev != -1) reminders.entries[reminder->prev].next = reminder->next;
+    else reminders.heads[bucket] = reminder->next;
+    if (reminder->next != -1) reminders.entries[reminder->next].prev = reminder->prev;
+    if (bucket < WHEEL_DUE && reminders.heads[bucket] == -1) {
+        reminders.occupied[bucket / WHEEL_SLOTS] &= ~(1ULL << (bucket % WHEEL_SLOTS));
+    }
+    reminder->bucket = -1;
+}
+
+void placeReminder(int entry) {
+    long long fire = reminderTick(reminders.entries[entry].when);
+    long long delta = fire - reminders.tick;
+    if (delta <= 0) {
+        linkReminder(entry, WHEEL_DUE);
+        return;
+    }
+    
+    int level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= 1LL << (WHEEL_BITS * (level + 1))) {
+        level++;
+    }
+    if (delta >= 1LL << (WHEEL_BITS * WHEEL_LEVELS)) {
+        fire = reminders.tick + (1LL << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    }
+    int slot = (int)((fire >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+    linkReminder(entry, level * WHEEL_SLOTS + slot);
+}
+
+void cascadeReminders(int level, int slot) {
+    int bucket = level * WHEEL_SLOTS + slot;
+    int entry = reminders.heads[bucket];
+    reminders.heads[bucket] = -1;
+    reminders.occupied[level] &= ~(1ULL << slot);
+    
+    while (entry != -1) {
+        int next = reminders.entries[entry].next;
+        placeReminder(entry);
+        entry = next;
+    }
+}
+
+void advanceReminders(long long target) {
+    while (reminders.tick < target) {
+        long long next = reminders.tick + 1;
+        long long end = (next | (WHEEL_SLOTS - 1)) < target ? (next | (WHEEL_SLOTS - 1)) : target;
+        
+        if ((next & (WHEEL_SLOTS - 1)) == 0) {
+            reminders.tick = next;
+            for (int level = WHEEL_LEVELS - 1; level > 0; level--) {
+                long long span = 1LL << (WHEEL_BITS * level);
+                if ((next & (span - 1)) == 0) {
+                    cascadeReminders(level, (int)((next >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)));
+                }
+            }
+        }
+        
+        int first = (int)(next & (WHEEL_SLOTS - 1));
+        int last = (int)(end & (WHEEL_SLOTS - 1));
+        unsigned long long hits = reminders.occupied[0] &
+                                  (~0ULL >> (WHEEL_SLOTS - 1 - last)) & (~0ULL << first);
+        while (hits != 0) {
+            int slot = __builtin_ctzll(hits);
+            hits &= hits - 1;
+            while (reminders.heads[slot] != -1) {
+                int entry = reminders.heads[slot];
+                unlinkReminder(entry);
+                linkReminder(entry, WHEEL_DUE);
+            }
+        }
+        reminders.tick = end;
+    }
+}
+
+void scheduleReminders(int transIndex) {
+    const Transaction *trans = &transactions[transIndex];
+    int soon = transIndex * REMINDER_KINDS + REMINDER_DUE_SOON;
+    int overdue = transIndex * REMINDER_KINDS + REMINDER_OVERDUE;
+    
+    cancelReminders(transIndex);
+    if (reminderTick(trans->dueDate) > reminders.tick) {
+        reminders.entries[soon].when = trans->dueDate - REMINDER_LEAD_DAYS * SECONDS_PER_DAY;
+        placeReminder(soon);
+    }
+    reminders.entries[overdue].when = trans->dueDate;
+    placeReminder(overdue);
+    reminders.transactionCount = transactionCount;
+}
+
+void cancelReminders(int transIndex) {
+    for (int kind = 0; kind < REMINDER_KINDS; kind++) {
+        unlinkReminder(transIndex * REMINDER_KINDS + kind);
+    }
+}
+
+void rebuildReminders(time_t now) {
+    memset(&reminders, 0, sizeof(ReminderWheel));
+    clearReminderMarks();
+    reminderRewrite = 1;
+    reminders.version = REMINDERS_VERSION;
+    reminders.tick = reminderTick(now);
+    for (int b = 0; b <= WHEEL_DUE; b++) {
+        reminders.heads[b] = -1;
+    }
+    for (int e = 0; e < MAX_TRANSACTIONS * REMINDER_KINDS; e++) {
+        reminders.entries[e].bucket = -1;
+    }
+    
+    for (int i = 0; i < transactionCount; i++) {
+        if (!transactions[i].isReturned) scheduleReminders(i);
+    }
+    reminders.transactionCount = transactionCount;
+}
+
+void loadReminders() {
+    FILE *file = fopen(dataPath(REMINDERS_FILE), "rb");
+    if (file != NULL) {
+        int loaded = fread(&reminders, sizeof(ReminderWheel), 1, file) == 1 &&
+                     reminders.version == REMINDERS_VERSION &&
+                     reminders.transactionCount == transactionCount;
+        fclose(file);
+        if (loaded) {
+            clearReminderMarks();
+            reminderRewrite = 0;
+            return;
+        }
+    }
+    
+    rebuildReminders(libraryNow());
+    saveReminders();
+}
+
+void saveReminders() {
+    FILE *file = reminderRewrite ? NULL : fopen(dataPath(REMINDERS_FILE), "r+b");
+    if (file != NULL) {
+        fwrite(&reminders, 1, (size_t)((char *)reminders.entries - (char *)&reminders), file);
+        markSharedRange(SHARED_REMINDERS, &reminders,
+                        (size_t)((char *)reminders.entries - (char *)&reminders));
+        for (int i = 0; i < reminderDirtyCount; i++) {
+            int entry = reminderDirty[i];
+            markSharedRange(SHARED_REMINDERS, &reminders.entries[entry], sizeof(Reminder));
+            fseek(file, (long)((char *)&reminders.entries[entry] - (char *)&reminders), SEEK_SET);
+            fwrite(&reminders.entries[entry], sizeof(Reminder), 1, file);
+        }
+        fclose(file);
+        clearReminderMarks();
+        return;
+    }
+    
+    file = fopen(dataPath(REMINDERS_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving reminders!\n");
+        return;
+    }
+    
+    fwrite(&reminders, sizeof(ReminderWheel), 1, file);
+    fclose(file);
+    markSharedRange(SHARED_REMINDERS, &reminders, sizeof(ReminderWheel));
+    clearReminderMarks();
+    reminderRewrite = 0;
+}
+
+int sendReminders(time_t until) {
+    advanceReminders(reminderTick(until));
+    
+    FILE *outbox = fopen(dataPath(OUTBOX_FILE), "a");
+    if (outbox == NULL) return -1;
+    
+    int sent = 0;
+    int entry = reminders.heads[WHEEL_DUE];
+    while (entry != -1) {
+        Reminder *reminder = &reminders.entries[entry];
+        int next = reminder->next;
+        if (reminder->when > until) {
+            entry = next;
+            continue;
+        }
+        
+        int transIndex = entry / REMINDER_KINDS;
+        int kind = entry % REMINDER_KINDS;
+        const Transaction *trans = &transactions[transIndex];
+        unlinkReminder(entry);
+        
+        if (kind == REMINDER_DUE_SOON && trans->dueDate <= until) {
+            entry = next;
+            continue;
+        }
+        if (!trans->isReturned) {
+            const Member *member = memberRecord(trans->memberID);
+            int daysLate = getDaysDifference(trans->dueDate, until);
+            float fine = kind == REMINDER_OVERDUE
+                ? fineForDaysLate(transactionPolicy(trans), daysLate)
+                : 0.0f;
+            char whenStr[12], dueStr[12];
+            formatDate(reminder->when, whenStr);
+            formatDate(trans->dueDate, dueStr);
+            
+            fprintf(outbox, "%s\t%s\t%d\t%d\t%s\t%s\t%s\t%d\t%s\t%.2f\n",
+                    whenStr, reminderKindNames[kind], trans->transactionID, trans->memberID,
+                    member != NULL ? member->name : "Unknown", member != NULL ? member->email : "",
+                    bookTitleFor(trans->bookID), trans->copyBarcode, dueStr, fine);
+            sent++;
+            
+            if (kind == REMINDER_OVERDUE) {
+                reminder->when += REMINDER_REPEAT_DAYS * SECONDS_PER_DAY;
+                placeReminder(entry);
+            }
+        }
+        entry = next;
+    }
+    
+    fclose(outbox);
+    saveReminders();
+    return sent;
+}
+
+void sendRemindersMenu() {
+    printHeader("SEND DUE-DATE REMINDERS");
+    
+    sharedBegin();
+    int sent = sendReminders(libraryNow());
+    if (sent < 0) {
+        printf("✗ Could not open %s!\n", dataPath(OUTBOX_FILE));
+    } else {
+        printf("✓ Wrote %d notice(s) to %s\n", sent, dataPath(OUTBOX_FILE));
+    }
+    pauseScreen();
+}
+
+void loadHolds() {
+    holdCount = 0;
+    
+    FILE *file = fopen(dataPath(HOLDS_FILE), "rb");
+    if (file != NULL) {
+        if (fread(&holdCount, sizeof(int), 1, file) != 1 || holdCount < 0 || holdCount > MAX_HOLDS) {
+            printf("Error loading holds!\n");
+            holdCount = 0;
+        }
+        holdCount = (int)fread(holds, sizeof(Hold), holdCount, file);
+        fclose(file);
+    }
+    
+    rebuildHoldQueues();
+}
+
+int compactHolds() {
+    int kept = 0;
+    for (int h = 0; h < holdCount; h++) {
+        int open = holds[h].status == HOLD_WAITING || holds[h].status == HOLD_READY;
+        if (open || h == holdCount - 1) {
+            holds[kept++] = holds[h];
+        }
+    }
+    
+    int reclaimed = holdCount - kept;
+    holdCount = kept;
+    rebuildHoldQueues();
+    return reclaimed;
+}
+
+void saveHolds() {
+    sharedDirty |= 1 << SHARED_HOLDS;
+    FILE *file = fopen(dataPath(HOLDS_FILE), "wb");
+    if (file == NULL) {
+        printf("Error saving holds!\n");
+        return;
+    }
+    
+    fwrite(&holdCount, sizeof(int), 1, file);
+    fwrite(holds, sizeof(Hold), holdCount, file);
+    fclose(file);
+}
+
+void rebuildHoldQueues() {
+    memset(holdQueueHead, -1, sizeof(holdQueueHead));
+    memset(holdQueueTail, -1, sizeof(holdQueueTail));
+    memset(memberHoldHead, -1, sizeof(memberHoldHead));
+    readyHoldCount = 0;
+    
+    for (int i = 0; i < holdCount; i++) {
+        int bookIndex = findBookSlot(holds[i].bookID);
+        int memberIndex = findMemberSlot(holds[i].memberID);
+        holdQueueNext[i] = -1;
+        memberHoldNext[i] = -1;
+        
+        if (memberIndex != -1) {
+            memberHoldNext[i] = memberHoldHead[memberIndex];
+            memberHoldHead[memberIndex] = i;
+        }
+        
+        if (holds[i].status == HOLD_READY) {
+            readyHoldCount++;
+        } else if (holds[i].status == HOLD_WAITING && bookIndex != -1) {
+            if (holdQueueTail[bookIndex] == -1) {
+                holdQueueHead[bookIndex] = i;
+            } else {
+                holdQueueNext[holdQueueTail[bookIndex]] = i;
+            }
+            holdQueueTail[bookIndex] = i;
+        }
+    }
+}
+
+int placeHold(int bookIndex, int memberIndex, time_t now) {
+    if (holdCount >= MAX_HOLDS && compactHolds() == 0) {
+        return -1;
+    }
+    
+    for (int h = memberHoldHead[memberIndex]; h != -1; h = memberHoldNext[h]) {
+        if (holds[h].bookID == books[bookIndex].bookID &&
+            (holds[h].status == HOLD_WAITING || holds[h].status == HOLD_READY)) {
+            return -1;
+        }
+    }
+    
+    int h = holdCount++;
+    holds[h].holdID = h == 0 ? 7001 : holds[h - 1].holdID + 1;
+    holds[h].bookID = books[bookIndex].bookID;
+    holds[h].memberID = members[memberIndex].memberID;
+    holds[h].placedDate = now;
+    holds[h].expiryDate = now + (time_t)HOLD_WAIT_DAYS * SECONDS_PER_DAY;
+    holds[h].status = HOLD_WAITING;
+    
+    holdQueueNext[h] = -1;
+    if (holdQueueTail[bookIndex] == -1) {
+        holdQueueHead[bookIndex] = h;
+    } else {
+        holdQueueNext[holdQueueTail[bookIndex]] = h;
+    }
+    holdQueueTail[bookIndex] = h;
+    
+    memberHoldNext[h] = memberHoldHead[memberIndex];
+    memberHoldHead[memberIndex] = h;
+    
+    return h;
+}
+
+int dispatchHold(int bookIndex, time_t now) {
+    while (holdQueueHead[bookIndex] != -1) {
+        int h = holdQueueHead[bookIndex];
+        holdQueueHead[bookIndex] = holdQueueNext[h];
+        if (holdQueueHead[bookIndex] == -1) {
+            holdQueueTail[bookIndex] = -1;
+        }
+        holdQueueNext[h] = -1;
+        
+        if (holds[h].expiryDate < now) {
+            holds[h].status = HOLD_EXPIRED;
+            continue;
+        }
+        
+        holds[h].status = HOLD_READY;
+        holds[h].expiryDate = now + (time_t)HOLD_PICKUP_DAYS * SECONDS_PER_DAY;
+        readyHoldCount++;
+        return h;
+    }
+    return -1;
+}
+
+int findReadyHold(int bookIndex, int memberID) {
+    int memberIndex = findMemberSlot(memberID);
+    if (memberIndex == -1) {
+        return -1;
+    }
+    
+    for (int h = memberHoldHead[memberIndex]; h != -1; h = memberHoldNext[h]) {
+        if (holds[h].status == HOLD_READY && holds[h].bookID == books[bookIndex].bookID) {
+            return h;
+        }
+    }
+    return -1;
+}
+
+void releaseReservedCopy(int bookIndex, time_t now) {
+    if (bookIndex != -1 && dispatchHold(bookIndex, now) == -1) {
+        books[bookIndex].availableCopies++;
+        reindexBook(bookIndex);
+        
+        int copy = takeCopy(bookIndex, COPY_RESERVED);
+        if (copy != -1) {
+            setCopyStatus(bookIndex, copy, COPY_AVAILABLE);
+            saveCopyRange(&copyRows[bookIndex].items[copy], sizeof(Copy));
+        }
+    }
+}
+
+int expireHolds(time_t now) {
+    if (readyHoldCount == 0) {
+        return 0;
+    }
+    
+    int expired = 0;
+    for (int h = 0; h < holdCount; h++) {
+        if (holds[h].status == HOLD_READY && holds[h].expiryDate < now) {
+            holds[h].status = HOLD_EXPIRED;
+            readyHoldCount--;
+            releaseReservedCopy(findBookSlot(holds[h].bookID), now);
+            expired++;
+        }
+    }
+    
+    if (expired > 0) {
+        saveHolds();
+        saveBooks();
+    }
+    return expired;
+}
+
+void cancelHold(int holdIndex, time_t now) {
+    int bookIndex = findBookSlot(holds[holdIndex].bookID);
+    
+    if (holds[holdIndex].status == HOLD_WAITING && bookIndex != -1) {
+        int prev = -1;
+        for (int h = holdQueueHead[bookIndex]; h != -1; prev = h, h = holdQueueNext[h]) {
+            if (h != holdIndex) continue;
+            
+            if (prev == -1) {
+                holdQueueHead[bookIndex] = holdQueueNext[h];
+            } else {
+                holdQueueNext[prev] = holdQueueNext[h];
+            }
+            if (holdQueueTail[bookIndex] == h) {
+                holdQueueTail[bookIndex] = prev;
+            }
+            break;
+        }
+        holds[holdIndex].status = HOLD_CANCELLED;
+    } else if (holds[holdIndex].status == HOLD_READY) {
+        holds[holdIndex].status = HOLD_CANCELLED;
+        readyHoldCount--;
+        releaseReservedCopy(bookIndex, now);
+    }
+}
+
+void cancelBookHolds(int bookIndex, time_t now) {
+    while (holdQueueHead[bookIndex] != -1) {
+        cancelHold(holdQueueHead[bookIndex], now);
+    }
+}
+
+void cancelMemberHolds(int memberIndex, time_t now) {
+    for (int h = memberHoldHead[memberIndex]; h != -1; h = memberHoldNext[h]) {
+        cancelHold(h, now);
+    }
+}
+
+int holdQueuePosition(int holdIndex) {
+    int bookIndex = findBookSlot(holds[holdIndex].bookID);
+    if (bookIndex == -1 || holds[holdIndex].status != HOLD_WAITING) {
+        return 0;
+    }
+    
+    int position = 1;
+    for (int h = holdQueueHead[bookIndex]; h != -1 && h != holdIndex; h = holdQueueNext[h]) {
+        position++;
+    }
+    return position;
+}
+
+void placeHoldMenu(int memberID) {
+    printHeader("PLACE HOLD");
+    
+    int bookID;
+    printf("Enter Book ID: ");
+    scanf("%d", &bookID);
+    sharedBegin();
+    
+    int bookIndex = findBookSlot(bookID);
+    int memberIndex = findMemberSlot(memberID);
+    
+    if (bookIndex == -1 || !books[bookIndex].isActive) {
+        printf("\n✗ Book not found!\n");
+    } else if (memberIndex == -1 || !members[memberIndex].isActive) {
+        printf("\n✗ Member not found!\n");
+    } else if (books[bookIndex].availableCopies > 0) {
+        printf("\n✓ %s is available now - no hold needed.\n", books[bookIndex].title);
+    } else {
+        int h = placeHold(bookIndex, memberIndex, libraryNow());
+        if (h == -1) {
+            printf("\n✗ Hold could not be placed (already on hold or hold limit reached).\n");
+        } else {
+            saveHolds();
+            printf("\n✓ Hold %d placed on %s\n", holds[h].holdID, books[bookIndex].title);
+            printf("  Position in queue: %d\n", holdQueuePosition(h));
+        }
+    }
+    
+    pauseScreen();
+}
+
+void viewMyHolds(int memberID) {
+    printHeader("MY HOLDS");
+    sharedBegin();
+    
+    time_t now = libraryNow();
+    expireHolds(now);
+    
+    int memberIndex = findMemberSlot(memberID);
+    if (memberIndex == -1) {
+        printf("✗ Member not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("%-8s %-30s %-12s %-12s %-20s\n",
+           "Hold ID", "Book Title", "Placed", "Expires", "Status");
+    printf("────────────────────────────────────────────────────────────────────────────────\n");
+    
+    int count = 0;
+    for (int h = memberHoldHead[memberIndex]; h != -1; h = memberHoldNext[h]) {
+        if (holds[h].status != HOLD_WAITING && holds[h].status != HOLD_READY) continue;
+        
+        char placedStr[12], expiryStr[12];
+        formatDate(holds[h].placedDate, placedStr);
+        formatDate(holds[h].expiryDate, expiryStr);
+        
+        printf("%-8d %-30s %-12s %-12s ", holds[h].holdID,
+               bookTitleFor(holds[h].bookID), placedStr, expiryStr);
+        if (holds[h].status == HOLD_READY) {
+            printf("✓ Ready for pickup\n");
+        } else {
+            printf("Waiting (#%d)\n", holdQueuePosition(h));
+        }
+        count++;
+    }
+    
+    if (count == 0) {
+        printf("No active holds.\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\nEnter Hold ID to cancel (0 to go back): ");
+    sharedEnd();
+    int holdID;
+    scanf("%d", &holdID);
+    
+    if (holdID != 0) {
+        sharedBegin();
+        memberIndex = findMemberSlot(memberID);
+        int found = -1;
+        for (int h = memberIndex != -1 ? memberHoldHead[memberIndex] : -1; h != -1;
+             h = memberHoldNext[h]) {
+            if (holds[h].holdID == holdID &&
+                (holds[h].status == HOLD_WAITING || holds[h].status == HOLD_READY)) {
+                found = h;
+                break;
+            }
+        }
+        
+        if (found == -1) {
+            printf("\n✗ Hold not found!\n");
+        } else {
+            cancelHold(found, now);
+            saveHolds();
+            saveBooks();
+            printf("\n✓ Hold cancelled.\n");
+        }
+    }
+    
+    pauseScreen();
+}
+
+void viewHoldQueue() {
+    printHeader("HOLD QUEUE");
+    
+    int bookID;
+    printf("Enter Book ID: ");
+    scanf("%d", &bookID);
+    sharedBegin();
+    
+    expireHolds(libraryNow());
+    
+    int bookIndex = findBookSlot(bookID);
+    if (bookIndex == -1) {
+        printf("\n✗ Book not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\nBook: %s (Available: %d/%d)\n\n", books[bookIndex].title,
+           books[bookIndex].availableCopies, books[bookIndex].totalCopies);
+    
+    for (int h = 0; h < holdCount; h++) {
+        if (holds[h].status == HOLD_READY && holds[h].bookID == bookID) {
+            char expiryStr[12];
+            formatDate(holds[h].expiryDate, expiryStr);
+            printf("Reserved for member %d until %s\n", holds[h].memberID, expiryStr);
+        }
+    }
+    
+    printf("\n%-6s %-8s %-10s %-25s %-12s\n", "Pos", "Hold ID", "Member", "Name", "Placed");
+    printf("────────────────────────────────────────────────────────────────\n");
+    
+    int position = 0;
+    for (int h = holdQueueHead[bookIndex]; h != -1; h = holdQueueNext[h]) {
+        char placedStr[12];
+        formatDate(holds[h].placedDate, placedStr);
+        printf("%-6d %-8d %-10d %-25s %-12s\n", ++position, holds[h].holdID,
+               holds[h].memberID, memberNameFor(holds[h].memberID),
+               placedStr);
+    }
+    
+    if (position == 0) {
+        printf("No members waiting.\n");
+    }
+    
+    pauseScreen();
+}
+
+void displayMenuRecursive(int menuType) {
+    if (menuType == 0) return;
+    
+    if (menuType == 1) {
+        printf("→ Admin Menu\n");
+    } else if (menuType == 2) {
+        printf("  → Book Management\n");
+    } else if (menuType == 3) {
+        printf("    → View Books\n");
+    }
+    
+    displayMenuRecursive(menuType - 1);
+}
+
+void renderStatistics() {
+    int activeBooks = 0, activeMembers = 0, issuedBooks = 0;
+    float totalFines = 0.0;
+    
+    for (int i = 0; i < bookCount; i++) {
+        if (books[i].isActive) activeBooks++;
+    }
+    
+    for (int i = 0; i < memberCount; i++) {
+        if (members[i].isActive) {
+            activeMembers++;
+            totalFines += members[i].totalFines;
+        }
+    }
+    
+    for (int i = 0; i < transactionCount; i++) {
+        if (!transactions[i].isReturned) issuedBooks++;
+    }
+    
+    renderf("Total Books       : %d\n", activeBooks);
+    renderf("Total Members     : %d\n", activeMembers);
+    renderf("Currently Issued  : %d\n", issuedBooks);
+    renderf("Total Transactions: %d\n", transactionCount);
+    renderf("Total Fines       : Rs. %.2f\n", totalFines);
+}
+
+void viewStatistics() {
+    printHeader("LIBRARY STATISTICS");
+    
+    renderBegin(stdout, RENDER_TABLE);
+    renderStatistics();
+    renderEnd();
+    
+    pauseScreen();
+}
+
+void renderSnapshotReport(time_t taken) {
+    char takenStr[20];
+    strftime(takenStr, sizeof(takenStr), "%Y-%m-%d %H:%M:%S", localtime(&taken));
+    
+    renderf("LIBRARY REPORT - branch %s, snapshot taken %s\n", branches[currentBranch].name, takenStr);
+    renderf("════════════════════════════════════════════════════════════════════════════════\n\n");
+    
+    renderf("STATISTICS\n");
+    renderStatistics();
+    
+    renderf("\nOUTSTANDING LIABILITIES\n");
+    renderLiabilities(taken);
+    
+    renderf("\nCURRENTLY ISSUED\n");
+    if (renderIssuedBooks(taken) == 0) renderf("No books currently issued.\n");
+    
+    renderf("\nMOST BORROWED TITLES (all time)\n");
+    if (renderTopN(METRIC_TITLES, 0, TOP_N) == 0) renderf("No data.\n");
+    renderf("\nMOST ACTIVE MEMBERS (all time)\n");
+    if (renderTopN(METRIC_MEMBERS, 0, TOP_N) == 0) renderf("No data.\n");
+    renderf("\nMOST OVERDUE AUTHORS (all time)\n");
+    if (renderTopN(METRIC_AUTHORS, 0, TOP_N) == 0) renderf("No data.\n");
+    
+    renderf("\nTRANSACTION HISTORY BY MEMBER\n");
+    for (int i = 0; i < memberOrderCount; i++) {
+        Member *member = &members[memberOrder[ORDER_BY_ID][i]];
+        renderf("\n%d - %s\n", member->memberID, member->name);
+        if (renderMemberHistory(member->memberID) == 0) renderf("No transactions.\n");
+    }
+}
+
+int startSnapshotReport() {
+    time_t taken = libraryNow();
+    char name[MAX_STRING];
+    strftime(name, sizeof(name), "report_%Y%m%d_%H%M%S.txt", localtime(&taken));
+    const char *path = dataPath(name);
+    
+    #ifdef _WIN32
+        FILE *out = fopen(path, "w");
+        if (out == NULL) return 0;
+        renderBegin(out, RENDER_TABLE);
+        renderSnapshotReport(taken);
+        renderEnd();
+        fclose(out);
+        printf("\n✓ Report written to %s\n", path);
+        return 1;
+    #else
+        if (snapshotJobCount == MAX_SNAPSHOT_JOBS) {
+            pollSnapshotReports(1);
+        }
+        
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            FILE *out = fopen(path, "w");
+            if (out == NULL) _exit(1);
+            renderBegin(out, RENDER_TABLE);
+            renderSnapshotReport(taken);
+            renderEnd();
+            fclose(out);
+            _exit(0);
+        }
+        if (pid < 0) return 0;
+        
+        SnapshotJob *job = &snapshotJobs[snapshotJobCount++];
+        job->pid = (long)pid;
+        job->started = taken;
+        strcpy(job->path, path);
+        printf("\n✓ Snapshot taken. Writing %s in the background.\n", path);
+        return 1;
+    #endif
+}
+
+void pollSnapshotReports(int wait) {
+    #ifndef _WIN32
+        for (int i = 0; i < snapshotJobCount; i++) {
+            int status;
+            pid_t done = waitpid((pid_t)snapshotJobs[i].pid, &status, wait ? 0 : WNOHANG);
+            if (done == 0) continue;
+            
+            if (done > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+                printf("✓ Report ready: %s\n", snapshotJobs[i].path);
+            } else {
+                printf("✗ Report failed: %s\n", snapshotJobs[i].path);
+            }
+            snapshotJobs[i--] = snapshotJobs[--snapshotJobCount];
+        }
+    #else
+        (void)wait;
+    #endif
+}
+
+void snapshotReportMenu() {
+    printHeader("SNAPSHOT REPORT");
+    
+    printf("The full report (statistics, liabilities, issued books, popularity\n");
+    printf("and every member's history) is written from a point-in-time snapshot\n");
+    printf("while the desk keeps working.\n");
+    
+    if (!startSnapshotReport()) {
+        printf("\n✗ Could not start the report!\n");
+    }
+    pauseScreen();
+}
+
+void branchFilePath(int branch, const char *file, char *path) {
+    if (branch == 0) {
+        strcpy(path, file);
+    } else {
+        sprintf(path, "%s_%s", branches[branch].name, file);
+    }
+}
+
+const char *dataPath(const char *file) {
+    static char paths[4][MAX_STRING];
+    static int next = 0;
+    char *path = paths[next++ & 3];
+    branchFilePath(currentBranch, file, path);
+    return path;
+}
+
+void loadBranches() {
+    branchCount = 1;
+    strcpy(branches[0].name, "main");
+    
+    FILE *file = fopen(BRANCHES_FILE, "rb");
+    if (file == NULL) return;
+    
+    int count;
+    if (fread(&count, sizeof(int), 1, file) == 1 && count >= 1 && count <= MAX_BRANCHES &&
+        fread(branches, sizeof(Branch), count, file) == (size_t)count) {
+        branchCount = count;
+    }
+    fclose(file);
+}
+
+void saveBranches() {
+    FILE *file = fopen(BRANCHES_FILE, "wb");
+    if (file == NULL) {
+        printf("Error saving branches!\n");
+        return;
+    }
+    
+    fwrite(&branchCount, sizeof(int), 1, file);
+    fwrite(branches, sizeof(Branch), branchCount, file);
+    fclose(file);
+}
+
+int findBranch(const char *name) {
+    for (int i = 0; i < branchCount; i++) {
+        if (compareFolded(branches[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+int branchForBookID(int bookID) {
+    int branch = (bookID - 1001) / BRANCH_ID_SPAN;
+    return bookID > 1000 && branch < branchCount ? branch : -1;
+}
+
+int branchForMemberID(int memberID) {
+    int branch = (memberID - 2001) / BRANCH_ID_SPAN;
+    return memberID > 2000 && branch < branchCount ? branch : -1;
+}
+
+void printOwningBranch(const char *what, int branch) {
+    if (branch != -1 && branch != currentBranch) {
+        printf("  %s belongs to branch '%s' (use --branch %s).\n",
+               what, branches[branch].name, branches[branch].name);
+    }
+}
+
+int loadShardBooks(int branch, Book *out) {
+    char path[MAX_STRING];
+    branchFilePath(branch, BOOKS_FILE, path);
+    
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    
+    int count = 0;
+    if (fread(&count, sizeof(int), 1, file) != 1 || count < 0 || count > MAX_BOOKS) {
+        count = 0;
+    }
+    count = (int)fread(out, sizeof(Book), count, file);
+    fclose(file);
+    return count;
+}
+
+int saveShardBooks(int branch, const Book *in, int count) {
+    char path[MAX_STRING];
+    branchFilePath(branch, BOOKS_FILE, path);
+    
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return 0;
+    
+    fwrite(&count, sizeof(int), 1, file);
+    fwrite(in, sizeof(Book), count, file);
+    fclose(file);
+    
+    branchFilePath(branch, CHECKSUMS_FILE, path);
+    recordChecksumsAt(path, CHECKED_BOOKS, in, count, 0, count);
+    return 1;
+}
+
+void *searchShard(void *arg) {
+    ShardSearch *shard = arg;
+    int count = loadShardBooks(shard->branch, shard->books);
+    
+    shard->count = 0;
+    for (int i = 0; i < count; i++) {
+        Book *book = &shard->books[i];
+        if (book->isActive &&
+            (containsFolded(book->title, shard->text) ||
+             containsFolded(book->author, shard->text) ||
+             compareFolded(book->ISBN, shard->text) == 0)) {
+            shard->books[shard->count++] = *book;
+        }
+    }
+    return NULL;
+}
+
+int compareCatalogMatches(const void *a, const void *b) {
+    const CatalogMatch *x = a, *y = b;
+    if (x->book.bookID != y->book.bookID) return x->book.bookID - y->book.bookID;
+    return x->branch - y->branch;
+}
+
+int catalogSearch(const char *text, CatalogMatch *out) {
+    static ShardSearch shards[MAX_BRANCHES];
+    char needle[MAX_STRING];
+    strncpy(needle, text, MAX_STRING - 1);
+    needle[MAX_STRING - 1] = '\0';
+    toLowerCase(needle);
+    
+    for (int i = 0; i < branchCount; i++) {
+        shards[i].branch = i;
+        shards[i].text = needle;
+        shards[i].books = malloc(sizeof(Book) * MAX_BOOKS);
+        shards[i].count = 0;
+    }
+    
+    #ifdef _WIN32
+        for (int i = 0; i < branchCount; i++) {
+            if (shards[i].books != NULL) searchShard(&shards[i]);
+        }
+    #else
+        pthread_t threads[MAX_BRANCHES];
+        int started[MAX_BRANCHES];
+        for (int i = 0; i < branchCount; i++) {
+            started[i] = shards[i].books != NULL &&
+                         pthread_create(&threads[i], NULL, searchShard, &shards[i]) == 0;
+            if (!started[i] && shards[i].books != NULL) searchShard(&shards[i]);
+        }
+        for (int i = 0; i < branchCount; i++) {
+            if (started[i]) pthread_join(threads[i], NULL);
+        }
+    #endif
+    
+    int found = 0;
+    for (int i = 0; i < branchCount; i++) {
+        for (int j = 0; j < shards[i].count; j++) {
+            out[found].branch = i;
+            out[found++].book = shards[i].books[j];
+        }
+        free(shards[i].books);
+    }
+    
+    qsort(out, found, sizeof(CatalogMatch), compareCatalogMatches);
+    return found;
+}
+
+int renderCatalog(const char *text) {
+    static CatalogMatch matches[MAX_BRANCHES * MAX_BOOKS];
+    int found = catalogSearch(text, matches);
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("id\ttitle\tauthor\tbranch\tavailable\ttotal\n");
+    } else {
+        renderf("%-8s %-30s %-20s %-15s %-8s\n", "ID", "Title", "Author", "Branch", "Avail");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < found; i++) {
+        Book *book = &matches[i].book;
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%s\t%s\t%d\t%d\n", book->bookID, book->title, book->author,
+                    branches[matches[i].branch].name, book->availableCopies,
+                    book->totalCopies);
+        } else {
+            renderf("%-8d %-30s %-20s %-15s %d/%d\n", book->bookID, book->title,
+                    book->author, branches[matches[i].branch].name,
+                    book->availableCopies, book->totalCopies);
+        }
+    }
+    return found;
+}
+
+int renderBranches() {
+    if (renderMode == RENDER_TSV) {
+        renderf("branch\tname\tbook_ids\tmember_ids\n");
+    } else {
+        renderf("%-4s %-20s %-20s %-20s\n", "No.", "Name", "Book IDs", "Member IDs");
+        renderf("────────────────────────────────────────────────────────────────\n");
+    }
+    
+    for (int i = 0; i < branchCount; i++) {
+        int bookBase = 1001 + i * BRANCH_ID_SPAN;
+        int memberBase = 2001 + i * BRANCH_ID_SPAN;
+        if (renderMode == RENDER_TSV) {
+            renderf("%d\t%s\t%d-%d\t%d-%d\n", i + 1, branches[i].name,
+                    bookBase, bookBase + BRANCH_ID_SPAN - 1,
+                    memberBase, memberBase + BRANCH_ID_SPAN - 1);
+        } else {
+            char bookRange[32], memberRange[32];
+            sprintf(bookRange, "%d-%d", bookBase, bookBase + BRANCH_ID_SPAN - 1);
+            sprintf(memberRange, "%d-%d", memberBase, memberBase + BRANCH_ID_SPAN - 1);
+            renderf("%-4d %-20s %-20s %-20s%s\n", i + 1, branches[i].name,
+                    bookRange, memberRange, i == currentBranch ? " (current)" : "");
+        }
+    }
+    return branchCount;
+}
+
+int selectBranchArgument(int *argc, char *argv[]) {
+    for (int i = 1; i + 1 < *argc; i++) {
+        if (strcmp(argv[i], "--branch") == 0) {
+            int branch = findBranch(argv[i + 1]);
+            if (branch == -1) {
+                fprintf(stderr, "Unknown branch: %s\n", argv[i + 1]);
+                exit(1);
+            }
+            currentBranch = branch;
+            for (int j = i; j + 2 < *argc; j++) {
+                argv[j] = argv[j + 2];
+            }
+            *argc -= 2;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int selectSharedArgument(int *argc, char *argv[]) {
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "--shared") == 0) {
+            for (int j = i; j + 1 < *argc; j++) {
+                argv[j] = argv[j + 1];
+            }
+            (*argc)--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int attachShared() {
+    #ifdef _WIN32
+        fprintf(stderr, "Shared mode is not available on Windows\n");
+        return 0;
+    #else
+        int fd = open(dataPath(SHARED_FILE), O_RDWR | O_CREAT, 0644);
+        if (fd == -1) return 0;
+        
+        int first = flock(fd, LOCK_EX | LOCK_NB) == 0;
+        if (!first) flock(fd, LOCK_SH);
+        
+        struct stat info;
+        if ((first && ftruncate(fd, sizeof(SharedTables)) == -1) ||
+            fstat(fd, &info) == -1 || info.st_size != (off_t)sizeof(SharedTables)) {
+            close(fd);
+            return 0;
+        }
+        
+        void *region = mmap(NULL, sizeof(SharedTables), PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+        if (region == MAP_FAILED) {
+            close(fd);
+            return 0;
+        }
+        sharedTables = region;
+        
+        if (first) {
+            pthread_mutexattr_t attr;
+            pthread_mutexattr_init(&attr);
+            pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+            pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+            memset(sharedTables, 0, sizeof(SharedTables));
+            pthread_mutex_init(&sharedTables->lock, &attr);
+            pthread_mutexattr_destroy(&attr);
+            
+            markSharedAll();
+            pushShared();
+            sharedTables->magic = SHARED_MAGIC;
+            flock(fd, LOCK_SH);
+        } else if (sharedTables->magic != SHARED_MAGIC) {
+            munmap(region, sizeof(SharedTables));
+            sharedTables = NULL;
+            close(fd);
+            return 0;
+        }
+        sharedDirty = 0;
+        return 1;
+    #endif
+}
+
+char *sharedRangeTable(int table, int inShared) {
+    #ifndef _WIN32
+        if (inShared) {
+            if (table == SHARED_ANALYTICS) return (char *)&sharedTables->analytics;
+            if (table == SHARED_CIRCULATION) return (char *)&sharedTables->circulation;
+            return (char *)&sharedTables->reminders;
+        }
+    #endif
+    if (table == SHARED_ANALYTICS) return (char *)&analytics;
+    if (table == SHARED_CIRCULATION) return (char *)&circulation;
+    return (char *)&reminders;
+}
+
+size_t sharedRangeSize(int table) {
+    if (table == SHARED_ANALYTICS) return sizeof(Analytics);
+    if (table == SHARED_CIRCULATION) return sizeof(Circulation);
+    return sizeof(ReminderWheel);
+}
+
+void markSharedRange(int table, const void *field, size_t size) {
+    #ifndef _WIN32
+        if (sharedTables == NULL) return;
+        
+        sharedDirty |= 1 << table;
+        if (sharedPendingCount == SHARED_RANGE_SLOTS) {
+            sharedPendingCount = 0;
+            for (int t = SHARED_ANALYTICS; t <= SHARED_REMINDERS; t++) {
+                markSharedRange(t, sharedRangeTable(t, 0), sharedRangeSize(t));
+            }
+        }
+        
+        SharedRange *range = &sharedPending[sharedPendingCount++];
+        range->table = table;
+        range->offset = (int)((const char *)field - sharedRangeTable(table, 0));
+        range->size = (int)size;
+    #endif
+}
+
+void markSharedAll() {
+    sharedDirty |= (1 << SHARED_ANALYTICS) - 1;
+    for (int t = SHARED_ANALYTICS; t <= SHARED_REMINDERS; t++) {
+        markSharedRange(t, sharedRangeTable(t, 0), sharedRangeSize(t));
+    }
+}
+
+int pushRows(char *shared, const char *local, unsigned long long *generations,
+             int count, int fresh, size_t size, unsigned long long generation) {
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        if (i < fresh && memcmp(shared + i * size, local + i * size, size) == 0) continue;
+        memcpy(shared + i * size, local + i * size, size);
+        generations[i] = generation;
+        changed++;
+    }
+    return changed;
+}
+
+int bookKeysChanged(const Book *a, const Book *b) {
+    return a->bookID != b->bookID || a->isActive != b->isActive || a->price != b->price ||
+           strcmp(a->title, b->title) != 0 || strcmp(a->author, b->author) != 0 ||
+           strcmp(a->ISBN, b->ISBN) != 0 || strcmp(a->category, b->category) != 0;
+}
+
+int pullBookRows(unsigned long long seen) {
+    int moved = 0;
+    #ifndef _WIN32
+        int oldCount = bookCount;
+        bookCount = sharedTables->bookCount;
+        
+        for (int i = 0; i < bookCount; i++) {
+            if (sharedTables->bookGenerations[i] <= seen) continue;
+            
+            const Book *next = &sharedTables->books[i];
+            int fresh = i >= oldCount || books[i].bookID != next->bookID;
+            int keyed = fresh || bookKeysChanged(&books[i], next);
+            if (i < oldCount && keyed && books[i].isActive) {
+                btreeRemoveBook(i);
+                unindexBookTerms(i);
+            }
+            if (i < oldCount && fresh) {
+                unindexBookSlot(i);
+                moved = 1;
+            }
+            
+            books[i] = *next;
+            if (fresh) indexBookSlot(i);
+            classifyBook(i);
+            reindexBook(i);
+            if (keyed && books[i].isActive) {
+                btreeInsertBook(i);
+                indexBookTerms(i);
+            }
+        }
+    #endif
+    return moved;
+}
+
+int pullMemberRows(unsigned long long seen) {
+    int moved = 0;
+    #ifndef _WIN32
+        int oldCount = memberCount;
+        memberCount = sharedTables->memberCount;
+        
+        for (int i = 0; i < memberCount; i++) {
+            if (sharedTables->memberGenerations[i] <= seen) continue;
+            
+            const Member *next = &sharedTables->members[i];
+            int fresh = i >= oldCount || members[i].memberID != next->memberID;
+            int renamed = fresh || strcmp(members[i].name, next->name) != 0;
+            if (i < oldCount && fresh) {
+                unindexMemberSlot(i);
+                moved = 1;
+            }
+            
+            members[i] = *next;
+            if (fresh) indexMemberSlot(i);
+            reindexMember(i);
+            if (renamed) indexMemberTerms(i);
+        }
+    #endif
+    return moved;
+}
+
+void pullTransactionRows(unsigned long long seen) {
+    #ifndef _WIN32
+        int oldCount = transactionCount;
+        transactionCount = sharedTables->transactionCount;
+        
+        for (int i = 0; i < transactionCount; i++) {
+            if (sharedTables->transactionGenerations[i] <= seen) continue;
+            
+            int wasOpen = i < oldCount && !transactions[i].isReturned;
+            transactions[i] = sharedTables->transactions[i];
+            if (i >= oldCount) {
+                recordLoanDelta(i, 1, transactions[i].issueDate);
+            }
+            if ((i >= oldCount || wasOpen) && transactions[i].isReturned) {
+                recordLoanDelta(i, 0, transactions[i].returnDate);
+            }
+        }
+    #endif
+}
+
+void pullRanges(unsigned long long seen) {
+    #ifndef _WIN32
+        SharedTables *shared = sharedTables;
+        int rebuildTree = 0;
+        
+        if (seen < shared->rangeFloor) {
+            for (int t = SHARED_ANALYTICS; t <= SHARED_REMINDERS; t++) {
+                memcpy(sharedRangeTable(t, 0), sharedRangeTable(t, 1), sharedRangeSize(t));
+            }
+            buildCirculationTree();
+            suggestDirty = 1;
+            return;
+        }
+        
+        long cells = (char *)circulation.days - (char *)&circulation;
+        unsigned long long first = shared->rangeCount > SHARED_RANGE_SLOTS
+            ? shared->rangeCount - SHARED_RANGE_SLOTS : 0;
+        for (unsigned long long r = first; r < shared->rangeCount; r++) {
+            const SharedRange *range = &shared->ranges[r % SHARED_RANGE_SLOTS];
+            if (range->generation <= seen) continue;
+            
+            if (range->table == SHARED_ANALYTICS) suggestDirty = 1;
+            if (range->table == SHARED_CIRCULATION) {
+                long cell = (range->offset - cells) / (long)sizeof(DayCounts);
+                if (range->size == sizeof(DayCounts) && range->offset >= cells &&
+                    (range->offset - cells) % sizeof(DayCounts) == 0 &&
+                    cell < CIRCULATION_SERIES * CIRCULATION_DAYS) {
+                    int series = (int)(cell / CIRCULATION_DAYS);
+                    int index = (int)(cell % CIRCULATION_DAYS);
+                    DayCounts delta = shared->circulation.days[series][index];
+                    addDayCounts(&delta, &circulation.days[series][index], -1);
+                    for (int i = index + 1; i <= CIRCULATION_DAYS; i += i & -i) {
+                        addDayCounts(&circulationTree[series][i], &delta, 1);
+                    }
+                } else {
+                    rebuildTree = 1;
+                }
+            }
+            memcpy(sharedRangeTable(range->table, 0) + range->offset,
+                   sharedRangeTable(range->table, 1) + range->offset, range->size);
+        }
+        if (rebuildTree) buildCirculationTree();
+    #endif
+}
+
+void rebuildSharedState() {
+    rebuildTemporalIndex();
+    rebuildIDIndexes();
+    rebuildPolicyClasses();
+    rebuildOrderIndexes();
+    rebuildBTrees();
+    rebuildTermIndex();
+    rebuildHoldQueues();
+    for (int slot = 0; slot < bookCount; slot++) {
+        rebuildCopyBitmaps(slot);
+    }
+    rebuildFreeSlots();
+    suggestDirty = 1;
+}
+
+void pullShared() {
+    #ifndef _WIN32
+        SharedTables *shared = sharedTables;
+        unsigned long long seen = sharedSeen;
+        unsigned long long *moved = shared->tableGenerations;
+        int rebuild = seen == 0 || shared->bookCount < bookCount ||
+                      shared->memberCount < memberCount ||
+                      shared->transactionCount < transactionCount;
+        if (rebuild) seen = 0;
+        
+        if (moved[SHARED_ARCHIVE] > seen) {
+            archivedBookCount = shared->archivedBookCount;
+            archivedMemberCount = shared->archivedMemberCount;
+            retiredBookID = shared->retiredBookID;
+            retiredMemberID = shared->retiredMemberID;
+            memcpy(archivedBooks, shared->archivedBooks, archivedBookCount * sizeof(Book));
+            memcpy(archivedMembers, shared->archivedMembers, archivedMemberCount * sizeof(Member));
+        }
+        if (moved[SHARED_ANALYTICS] > seen || moved[SHARED_CIRCULATION] > seen ||
+            moved[SHARED_REMINDERS] > seen) {
+            pullRanges(seen);
+        }
+        
+        if (rebuild) {
+            bookCount = shared->bookCount;
+            memberCount = shared->memberCount;
+            transactionCount = shared->transactionCount;
+            holdCount = shared->holdCount;
+            memcpy(books, shared->books, bookCount * sizeof(Book));
+            memcpy(members, shared->members, memberCount * sizeof(Member));
+            memcpy(transactions, shared->transactions, transactionCount * sizeof(Transaction));
+            memcpy(copyRows, shared->copyRows, bookCount * sizeof(CopyRow));
+            memcpy(holds, shared->holds, holdCount * sizeof(Hold));
+            rebuildSharedState();
+        } else {
+            int slotsMoved = 0;
+            if (moved[SHARED_BOOKS] > seen) slotsMoved |= pullBookRows(seen);
+            if (moved[SHARED_MEMBERS] > seen) slotsMoved |= pullMemberRows(seen);
+            if (moved[SHARED_BOOKS] > seen || moved[SHARED_MEMBERS] > seen) rebuildFreeSlots();
+            
+            if (moved[SHARED_COPIES] > seen) {
+                for (int i = 0; i < bookCount; i++) {
+                    if (shared->copyGenerations[i] <= seen) continue;
+                    copyRows[i] = shared->copyRows[i];
+                    rebuildCopyBitmaps(i);
+                }
+            }
+            if (moved[SHARED_TRANSACTIONS] > seen) pullTransactionRows(seen);
+            if (moved[SHARED_HOLDS] > seen || slotsMoved) {
+                holdCount = shared->holdCount;
+                for (int i = 0; i < holdCount; i++) {
+                    if (shared->holdGenerations[i] > seen) holds[i] = shared->holds[i];
+                }
+                rebuildHoldQueues();
+            }
+        }
+        
+        if (moved[SHARED_BOOKS] > seen) {
+            int synced = 0;
+            for (int i = 0; i < bookCount; i++) {
+                if (shared->bookGenerations[i] <= seen || !books[i].isActive) continue;
+                CopyRow before = copyRows[i];
+                if (copyRows[i].bookID != books[i].bookID) resetCopyRow(i);
+                syncCopies(i);
+                synced |= memcmp(&before, &copyRows[i], sizeof(CopyRow)) != 0;
+            }
+            if (synced) saveCopies();
+        }
+        
+        if (eventFile != NULL) {
+            fseek(eventFile, 0, SEEK_SET);
+            fread(&eventHeader, sizeof(EventRingHeader), 1, eventFile);
+        }
+        sharedSeen = shared->generation;
+    #endif
+}
+
+void pushShared() {
+    #ifndef _WIN32
+        SharedTables *shared = sharedTables;
+        unsigned long long generation = shared->generation + 1;
+        int changed[SHARED_TABLE_COUNT] = {0};
+        
+        if (sharedDirty & (1 << SHARED_COPIES)) {
+            changed[SHARED_COPIES] = pushRows((char *)shared->copyRows, (const char *)copyRows,
+                                              shared->copyGenerations, bookCount,
+                                              shared->bookCount, sizeof(CopyRow), generation);
+        }
+        if (sharedDirty & (1 << SHARED_BOOKS)) {
+            changed[SHARED_BOOKS] = pushRows((char *)shared->books, (const char *)books,
+                                             shared->bookGenerations, bookCount,
+                                             shared->bookCount, sizeof(Book), generation) +
+                                    (shared->bookCount != bookCount);
+            shared->bookCount = bookCount;
+        }
+        if (sharedDirty & (1 << SHARED_MEMBERS)) {
+            changed[SHARED_MEMBERS] = pushRows((char *)shared->members, (const char *)members,
+                                               shared->memberGenerations, memberCount,
+                                               shared->memberCount, sizeof(Member), generation) +
+                                      (shared->memberCount != memberCount);
+            shared->memberCount = memberCount;
+        }
+        if (sharedDirty & (1 << SHARED_TRANSACTIONS)) {
+            changed[SHARED_TRANSACTIONS] = pushRows((char *)shared->transactions,
+                                                    (const char *)transactions,
+                                                    shared->transactionGenerations, transactionCount,
+                                                    shared->transactionCount, sizeof(Transaction),
+                                                    generation) +
+                                           (shared->transactionCount != transactionCount);
+            shared->transactionCount = transactionCount;
+        }
+        if (sharedDirty & (1 << SHARED_HOLDS)) {
+            changed[SHARED_HOLDS] = pushRows((char *)shared->holds, (const char *)holds,
+                                             shared->holdGenerations, holdCount,
+                                             shared->holdCount, sizeof(Hold), generation) +
+                                    (shared->holdCount != holdCount);
+            shared->holdCount = holdCount;
+        }
+        if (sharedDirty & (1 << SHARED_ARCHIVE)) {
+            shared->archivedBookCount = archivedBookCount;
+            shared->archivedMemberCount = archivedMemberCount;
+            shared->retiredBookID = retiredBookID;
+            shared->retiredMemberID = retiredMemberID;
+            memcpy(shared->archivedBooks, archivedBooks, archivedBookCount * sizeof(Book));
+            memcpy(shared->archivedMembers, archivedMembers, archivedMemberCount * sizeof(Member));
+            changed[SHARED_ARCHIVE] = 1;
+        }
+        
+        for (int i = 0; i < sharedPendingCount; i++) {
+            SharedRange *range = &shared->ranges[shared->rangeCount % SHARED_RANGE_SLOTS];
+            if (shared->rangeCount >= SHARED_RANGE_SLOTS) shared->rangeFloor = range->generation;
+            *range = sharedPending[i];
+            range->generation = generation;
+            shared->rangeCount++;
+            memcpy(sharedRangeTable(range->table, 1) + range->offset,
+                   sharedRangeTable(range->table, 0) + range->offset, range->size);
+            changed[range->table] = 1;
+        }
+        sharedPendingCount = 0;
+        
+        for (int t = 0; t < SHARED_TABLE_COUNT; t++) {
+            if (!changed[t]) continue;
+            shared->tableGenerations[t] = generation;
+            shared->generation = generation;
+        }
+        sharedSeen = shared->generation;
+        sharedDirty = 0;
+    #endif
+}
+
+void sharedBegin() {
+    #ifndef _WIN32
+        if (sharedTables == NULL || sharedDepth++ > 0) return;
+        
+        if (pthread_mutex_lock(&sharedTables->lock) == EOWNERDEAD) {
+            pthread_mutex_consistent(&sharedTables->lock);
+            loadBooks();
+            loadMembers();
+            loadTransactions();
+            rebuildIDIndexes();
+            loadHolds();
+            loadCopies();
+            loadArchive();
+            loadAnalytics();
+            loadCirculation();
+            loadReminders();
+            rebuildSharedState();
+            markSharedAll();
+            pushShared();
+        }
+        
+        if (sharedDirty) {
+            pushShared();
+        } else if (sharedTables->generation != sharedSeen) {
+            pullShared();
+        }
+    #endif
+}
+
+void sharedEnd() {
+    #ifndef _WIN32
+        if (sharedTables == NULL || sharedDepth == 0 || --sharedDepth > 0) return;
+        
+        if (sharedDirty) pushShared();
+        pthread_mutex_unlock(&sharedTables->lock);
+    #endif
+}
+
+void sharedRelease() {
+    if (sharedDepth > 0) {
+        sharedDepth = 1;
+        sharedEnd();
+    }
+}
+
+void sharedRefresh() {
+    #ifndef _WIN32
+        if (sharedTables != NULL && sharedDepth == 0 && sharedTables->generation != sharedSeen) {
+            sharedBegin();
+            sharedEnd();
+        }
+    #endif
+}
+
+void chooseBranch() {
+    printHeader("SELECT BRANCH");
+    
+    renderBegin(stdout, RENDER_TABLE);
+    renderBranches();
+    renderEnd();
+    
+    printf("\nBranch No.: ");
+    int choice;
+    scanf("%d", &choice);
+    
+    if (choice >= 1 && choice <= branchCount) {
+        currentBranch = choice - 1;
+    }
+}
+
+void addBranch() {
+    printHeader("ADD BRANCH");
+    
+    if (branchCount >= MAX_BRANCHES) {
+        printf("✗ Branch limit reached!\n");
+        pauseScreen();
+        return;
+    }
+    
+    char name[BRANCH_NAME_LENGTH];
+    printf("Branch Name (letters and digits): ");
+    scanf("%19s", name);
+    
+    for (int i = 0; name[i]; i++) {
+        if (!isalnum((unsigned char)name[i])) {
+            printf("\n✗ Invalid branch name!\n");
+            pauseScreen();
+            return;
+        }
+    }
+    
+    if (findBranch(name) != -1) {
+        printf("\n✗ Branch already exists!\n");
+        pauseScreen();
+        return;
+    }
+    
+    strcpy(branches[branchCount++].name, name);
+    saveBranches();
+    
+    printf("\n✓ Branch '%s' added. Start it with: --branch %s\n", name, name);
+    pauseScreen();
+}
+
+void loadBranchLoans() {
+    FILE *file = fopen(BRANCH_LOANS_FILE, "rb");
+    branchLoanCount = 0;
+    if (file == NULL) return;
+    
+    if (fread(&branchLoanCount, sizeof(int), 1, file) != 1 ||
+        branchLoanCount < 0 || branchLoanCount > MAX_BRANCH_LOANS) {
+        branchLoanCount = 0;
+    }
+    branchLoanCount = (int)fread(branchLoans, sizeof(BranchLoan), branchLoanCount, file);
+    fclose(file);
+}
+
+void saveBranchLoans() {
+    FILE *file = fopen(BRANCH_LOANS_FILE, "wb");
+    if (file == NULL) {
+        printf("Error saving branch loans!\n");
+        return;
+    }
+    
+    fwrite(&branchLoanCount, sizeof(int), 1, file);
+    fwrite(branchLoans, sizeof(BranchLoan), branchLoanCount, file);
+    fclose(file);
+}
+
+int lockBranchFile(const char *path) {
+    #ifdef _WIN32
+        (void)path;
+        return -1;
+    #else
+        int fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd != -1) flock(fd, LOCK_EX);
+        return fd;
+    #endif
+}
+
+int tryBranchFile(const char *path, int *fd) {
+    *fd = -1;
+    #ifdef _WIN32
+        (void)path;
+    #else
+        *fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (*fd != -1 && flock(*fd, LOCK_EX | LOCK_NB) == -1) {
+            close(*fd);
+            *fd = -1;
+            return 0;
+        }
+    #endif
+    return 1;
+}
+
+void unlockBranchFile(int fd) {
+    #ifndef _WIN32
+        if (fd != -1) close(fd);
+    #endif
+}
+
+void holdBranchBooks() {
+    #ifndef _WIN32
+        int fd = open(dataPath(BOOKS_FILE), O_RDWR | O_CREAT, 0644);
+        if (fd == -1) return;
+        flock(fd, LOCK_SH);
+        
+        struct stat info;
+        int empty = 0;
+        if (fstat(fd, &info) == 0 && info.st_size == 0 &&
+            write(fd, &empty, sizeof(int)) != sizeof(int)) {
+            printf("Error saving books!\n");
+        }
+    #endif
+}
+
+int lockBranchShared(int branch, void **region) {
+    *region = NULL;
+    #ifdef _WIN32
+        (void)branch;
+    #else
+        char path[MAX_STRING];
+        branchFilePath(branch, SHARED_FILE, path);
+        int fd = open(path, O_RDWR);
+        if (fd == -1) return 1;
+        
+        struct stat info;
+        if (flock(fd, LOCK_EX | LOCK_NB) == 0 || fstat(fd, &info) == -1 ||
+            info.st_size != (off_t)sizeof(SharedTables)) {
+            close(fd);
+            return 1;
+        }
+        
+        SharedTables *shared = mmap(NULL, sizeof(SharedTables), PROT_READ | PROT_WRITE,
+                                    MAP_SHARED, fd, 0);
+        close(fd);
+        if (shared == MAP_FAILED) return 0;
+        
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += BRANCH_LOCK_SECONDS;
+        int status = shared->magic == SHARED_MAGIC ?
+                     pthread_mutex_timedlock(&shared->lock, &deadline) : ETIMEDOUT;
+        if (status == EOWNERDEAD) {
+            pthread_mutex_consistent(&shared->lock);
+        } else if (status != 0) {
+            munmap(shared, sizeof(SharedTables));
+            return 0;
+        }
+        *region = shared;
+    #endif
+    return 1;
+}
+
+void unlockBranchShared(void *region, const Book *shard, int count, int slot) {
+    #ifdef _WIN32
+        (void)region;
+        (void)shard;
+        (void)count;
+        (void)slot;
+    #else
+        SharedTables *shared = region;
+        if (shared == NULL) return;
+        
+        if (shard != NULL) {
+            unsigned long long generation = shared->generation + 1;
+            shared->books[slot] = shard[slot];
+            shared->bookGenerations[slot] = generation;
+            shared->bookCount = count;
+            shared->tableGenerations[SHARED_BOOKS] = generation;
+            shared->generation = generation;
+        }
+        pthread_mutex_unlock(&shared->lock);
+        munmap(shared, sizeof(SharedTables));
+    #endif
+}
+
+int moveShardCopies(int branch, const Book *book, int copies) {
+    static Book shard[MAX_BOOKS];
+    char path[MAX_STRING];
+    void *region;
+    branchFilePath(branch, BOOKS_FILE, path);
+    
+    int lock;
+    if (!tryBranchFile(path, &lock)) return -1;
+    if (!lockBranchShared(branch, &region)) {
+        unlockBranchFile(lock);
+        return 0;
+    }
+    int count = loadShardBooks(branch, shard);
+    
+    int found = -1;
+    for (int i = 0; i < count; i++) {
+        if (shard[i].bookID == book->bookID) {
+            found = i;
+            break;
+        }
+    }
     
-    printf("Address [%s]: ", members[found].address);
-    scanf(" %[^\n]", input);
-    if (strlen(input) > 0) strcpy(members[found].address, input);
+    if (found == -1 && copies >= 0 && count < MAX_BOOKS) {
+        found = count++;
+        shard[found] = *book;
+        shard[found].totalCopies = 0;
+        shard[found].availableCopies = 0;
+    }
     
-    saveMembers();
-    printf("\n✓ Member updated successfully!\n");
+    int moved = found != -1 && shard[found].availableCopies + copies >= 0;
+    if (moved) {
+        shard[found].isActive = 1;
+        shard[found].totalCopies += copies;
+        shard[found].availableCopies += copies;
+        moved = saveShardBooks(branch, shard, count);
+    }
+    unlockBranchShared(region, moved ? shard : NULL, count, found);
+    unlockBranchFile(lock);
+    return moved;
+}
+
+void printMoveFailure(int branch, int moved) {
+    if (moved == -1) {
+        printf("\n✗ Branch '%s' is open without --shared!\n", branches[branch].name);
+        printf("  Close it or restart its terminals with --shared, then try again.\n");
+    } else {
+        printf("\n✗ Could not update branch '%s'!\n", branches[branch].name);
+    }
+}
+
+void lendToBranch() {
+    printHeader("LEND COPIES TO BRANCH");
+    
+    if (branchCount < 2) {
+        printf("✗ No other branch to lend to!\n");
+        pauseScreen();
+        return;
+    }
+    
+    int bookID;
+    printf("Enter Book ID: ");
+    scanf("%d", &bookID);
+    
+    int slot = findBookSlot(bookID);
+    if (slot == -1) {
+        printf("\n✗ Book not found!\n");
+        pauseScreen();
+        return;
+    }
+    
+    printf("\n");
+    renderBegin(stdout, RENDER_TABLE);
+    renderBranches();
+    renderEnd();
+    
+    int target, copies;
+    printf("\nLend to Branch No.: ");
+    scanf("%d", &target);
+    printf("Copies (available %d): ", books[slot].availableCopies);
+    scanf("%d", &copies);
+    target--;
+    
+    if (target < 0 || target >= branchCount || target == currentBranch) {
+        printf("\n✗ Invalid branch!\n");
+        pauseScreen();
+        return;
+    }
+    
+    int log = lockBranchFile(BRANCH_LOANS_FILE);
+    sharedBegin();
+    loadBranchLoans();
+    if (branchLoanCount >= MAX_BRANCH_LOANS) {
+        unlockBranchFile(log);
+        printf("\n✗ Branch loan log is full (%d entries)!\n", MAX_BRANCH_LOANS);
+        pauseScreen();
+        return;
+    }
+    slot = findBookSlot(bookID);
+    if (slot == -1) {
+        unlockBranchFile(log);
+        printf("\n✗ Book was removed by another desk!\n");
+        pauseScreen();
+        return;
+    }
+    if (copies <= 0 || copies > books[slot].availableCopies) {
+        unlockBranchFile(log);
+        printf("\n✗ Not enough copies available!\n");
+        pauseScreen();
+        return;
+    }
+    
+    int moved = moveShardCopies(target, &books[slot], copies);
+    if (moved != 1) {
+        unlockBranchFile(log);
+        printMoveFailure(target, moved);
+        pauseScreen();
+        return;
+    }
+    
+    books[slot].totalCopies -= copies;
+    books[slot].availableCopies -= copies;
+    syncCopies(slot);
+    reindexBook(slot);
+    saveBooks();
+    saveCopies();
+    
+    BranchLoan *loan = &branchLoans[branchLoanCount];
+    loan->loanID = branchLoanCount > 0 ? branchLoans[branchLoanCount - 1].loanID + 1 : 1;
+    loan->bookID = bookID;
+    loan->fromBranch = currentBranch;
+    loan->toBranch = target;
+    loan->copies = copies;
+    loan->lentDate = libraryNow();
+    loan->returnDate = 0;
+    loan->isReturned = 0;
+    branchLoanCount++;
+    saveBranchLoans();
+    unlockBranchFile(log);
+    
+    printf("\n✓ %d copy(ies) of '%s' lent to branch '%s' (Loan #%d)\n",
+           copies, books[slot].title, branches[target].name, loan->loanID);
     pauseScreen();
 }
 
-void deleteMember() {
-    printHeader("DELETE MEMBER");
+void returnBranchLoan() {
+    printHeader("RETURN BRANCH LOAN");
+    loadBranchLoans();
+    
+    int open = 0;
+    printf("%-6s %-8s %-30s %-15s %-6s\n", "Loan", "Book ID", "Title", "From", "Copies");
+    printf("────────────────────────────────────────────────────────────────────\n");
+    for (int i = 0; i < branchLoanCount; i++) {
+        BranchLoan *loan = &branchLoans[i];
+        if (loan->isReturned || loan->toBranch != currentBranch) continue;
+        int slot = findBookSlot(loan->bookID);
+        printf("%-6d %-8d %-30s %-15s %-6d\n", loan->loanID, loan->bookID,
+               slot != -1 ? books[slot].title : "-",
+               branches[loan->fromBranch].name, loan->copies);
+        open++;
+    }
     
-    int id;
-    printf("Enter Member ID to delete: ");
-    scanf("%d", &id);
+    if (open == 0) {
+        printf("No open loans from other branches.\n");
+        pauseScreen();
+        return;
+    }
     
-    int found = -1;
-    for (int i = 0; i < memberCount; i++) {
-        if (members[i].memberID == id && members[i].isActive) {
-            found = i;
-            break;
+    int loanID;
+    printf("\nLoan to return: ");
+    scanf("%d", &loanID);
+    int log = lockBranchFile(BRANCH_LOANS_FILE);
+    sharedBegin();
+    loadBranchLoans();
+    
+    BranchLoan *loan = NULL;
+    for (int i = 0; i < branchLoanCount; i++) {
+        if (branchLoans[i].loanID == loanID && !branchLoans[i].isReturned &&
+            branchLoans[i].toBranch == currentBranch) {
+            loan = &branchLoans[i];
         }
     }
     
-    if (found == -1) {
-        printf("\n✗ Member not found!\n");
+    int slot = loan != NULL ? findBookSlot(loan->bookID) : -1;
+    if (slot == -1) {
+        unlockBranchFile(log);
+        printf("\n✗ Loan not found!\n");
+        pauseScreen();
+        return;
+    }
+    if (books[slot].availableCopies < loan->copies) {
+        unlockBranchFile(log);
+        printf("\n✗ %d copy(ies) still issued to members!\n",
+               loan->copies - books[slot].availableCopies);
         pauseScreen();
         return;
     }
     
-    if (members[found].booksIssued > 0) {
-        printf("\n✗ Cannot delete! Member has issued books.\n");
+    int moved = moveShardCopies(loan->fromBranch, &books[slot], loan->copies);
+    if (moved != 1) {
+        unlockBranchFile(log);
+        printMoveFailure(loan->fromBranch, moved);
         pauseScreen();
         return;
     }
     
-    printf("\nMember: %s (ID: %d)\n", members[found].name, members[found].memberID);
-    printf("Are you sure you want to delete? (y/n): ");
+    books[slot].totalCopies -= loan->copies;
+    books[slot].availableCopies -= loan->copies;
+    syncCopies(slot);
+    if (books[slot].totalCopies == 0 && branchForBookID(books[slot].bookID) != currentBranch) {
+        btreeRemoveBook(slot);
+        unindexBookTerms(slot);
+        books[slot].isActive = 0;
+        freeBookSlots[freeBookCount++] = slot;
+        cancelBookHolds(slot, libraryNow());
+        saveHolds();
+    }
+    reindexBook(slot);
+    saveBooks();
+    saveCopies();
     
-    char confirm;
-    scanf(" %c", &confirm);
+    loan->isReturned = 1;
+    loan->returnDate = libraryNow();
+    saveBranchLoans();
+    unlockBranchFile(log);
     
-    if (confirm == 'y' || confirm == 'Y') {
-        members[found].isActive = 0;
-        saveMembers();
-        printf("\n✓ Member deleted successfully!\n");
-    } else {
-        printf("\n✓ Deletion cancelled.\n");
+    printf("\n✓ Loan #%d returned to branch '%s'\n", loan->loanID,
+           branches[loan->fromBranch].name);
+    pauseScreen();
+}
+
+void viewBranchLoans() {
+    printHeader("INTER-BRANCH LOANS");
+    loadBranchLoans();
+    
+    printf("%-6s %-8s %-15s %-15s %-6s %-12s %-10s\n",
+           "Loan", "Book ID", "From", "To", "Copies", "Lent", "Status");
+    printf("────────────────────────────────────────────────────────────────────────────\n");
+    
+    int shown = 0;
+    for (int i = 0; i < branchLoanCount; i++) {
+        BranchLoan *loan = &branchLoans[i];
+        if (loan->fromBranch != currentBranch && loan->toBranch != currentBranch) continue;
+        
+        char lent[12];
+        formatDate(loan->lentDate, lent);
+        printf("%-6d %-8d %-15s %-15s %-6d %-12s %-10s\n", loan->loanID, loan->bookID,
+               branches[loan->fromBranch].name, branches[loan->toBranch].name,
+               loan->copies, lent, loan->isReturned ? "Returned" : "Open");
+        shown++;
     }
     
+    if (shown == 0) {
+        printf("No inter-branch loans for this branch.\n");
+    }
     pauseScreen();
 }
 
-void memberManagementMenu() {
+void branchMenu() {
     while (1) {
-        printHeader("MEMBER MANAGEMENT");
+        printHeader("BRANCHES");
+        printf("Current Branch: %s\n\n", branches[currentBranch].name);
         
-        printf("1. Add New Member\n");
-        printf("2. View All Members\n");
-        printf("3. Search Member\n");
-        printf("4. Update Member\n");
-        printf("5. Delete Member\n");
-        printf("6. Back to Main Menu\n");
+        printf("1. List Branches\n");
+        printf("2. Add Branch\n");
+        printf("3. Catalog Search (all branches)\n");
+        printf("4. Lend Copies to Branch\n");
+        printf("5. Return Branch Loan\n");
+        printf("6. View Inter-Branch Loans\n");
+        printf("7. Back to Admin Menu\n");
         printf("\nChoice: ");
         
         int choice;
         scanf("%d", &choice);
         
         switch (choice) {
-            case 1: addMember(); break;
-            case 2: viewAllMembers(); break;
-            case 3: searchMember(); break;
-            case 4: updateMember(); break;
-            case 5: deleteMember(); break;
-            case 6: return;
+            case 1:
+                printHeader("BRANCHES");
+                renderBegin(stdout, RENDER_TABLE);
+                renderBranches();
+                renderEnd();
+                pauseScreen();
+                break;
+            case 2: addBranch(); break;
+            case 3: {
+                char text[MAX_STRING];
+                printHeader("CATALOG SEARCH");
+                printf("Title, author or ISBN: ");
+                scanf(" %[^\n]", text);
+                printf("\n");
+                
+                renderBegin(stdout, RENDER_TABLE);
+                int found = renderCatalog(text);
+                renderEnd();
+                
+                printf("\n%d book(s) found across %d branch(es).\n", found, branchCount);
+                pauseScreen();
+                break;
+            }
+            case 4: lendToBranch(); break;
+            case 5: returnBranchLoan(); break;
+            case 6: viewBranchLoans(); break;
+            case 7: return;
+            default:
+                printf("\n✗ Invalid choice!\n");
+                pauseScreen();
+        }
+    }
+}
+
+void reportsMenu() {
+    while (1) {
+        printHeader("REPORTS & STATISTICS");
+        
+        printf("1. Library Statistics\n");
+        printf("2. Outstanding Liabilities\n");
+        printf("3. Popularity Analytics\n");
+        printf("4. Snapshot Report (background)\n");
+        printf("5. Export Data (CSV / JSON Lines)\n");
+        printf("6. Loans On Date / Period\n");
+        printf("7. Circulation Trends\n");
+        printf("8. Back to Admin Menu\n");
+        if (snapshotJobCount > 0) {
+            printf("\n");
+            pollSnapshotReports(0);
+            if (snapshotJobCount > 0) {
+                printf("%d report(s) running...\n", snapshotJobCount);
+            }
+        }
+        printf("\nChoice: ");
+        
+        int choice;
+        scanf("%d", &choice);
+        
+        switch (choice) {
+            case 1: viewStatistics(); break;
+            case 2: outstandingLiabilitiesReport(); break;
+            case 3: popularityReport(); break;
+            case 4: snapshotReportMenu(); break;
+            case 5: exportMenu(); break;
+            case 6: loansOnDateReport(); break;
+            case 7: circulationReport(); break;
+            case 8: return;
+            default:
+                printf("\n✗ Invalid choice!\n");
+                pauseScreen();
+        }
+    }
+}
+
+void adminMenu() {
+    while (1) {
+        printHeader("ADMIN DASHBOARD");
+        if (branchCount > 1) {
+            printf("Branch: %s\n\n", branches[currentBranch].name);
+        }
+        
+        printf("1. Book Management\n");
+        printf("2. Member Management\n");
+        printf("3. Transaction Management\n");
+        printf("4. Reports & Statistics\n");
+        printf("5. Branches\n");
+        printf("6. Logout\n");
+        printf("\nChoice: ");
+        
+        int choice;
+        scanf("%d", &choice);
+        
+        switch (choice) {
+            case 1:
+                bookManagementMenu();
+                break;
+            case 2:
+                memberManagementMenu();
+                break;
+            case 3:
+                transactionMenu();
+                break;
+            case 4:
+                reportsMenu();
+                break;
+            case 5:
+                branchMenu();
+                break;
+            case 6:
+                printf("\n✓ Logged out successfully!\n");
+                pauseScreen();
+                return;
             default:
                 printf("\n✗ Invalid choice!\n");
                 pauseScreen();
@@ -922,583 +8929,1262 @@ void memberManagementMenu() {
     }
 }
 
-void calculateFine(Transaction *trans) {
-    if (trans->isReturned) {
-        time_t returnDate = trans->returnDate;
-        int daysLate = getDaysDifference(trans->dueDate, returnDate);
-        
-        if (daysLate > 0) {
-            if (daysLate <= 7) {
-                trans->fine = daysLate * 2.0;
-            } else if (daysLate <= 14) {
-                trans->fine = (7 * 2.0) + ((daysLate - 7) * 4.0);
-            } else {
-                trans->fine = (7 * 2.0) + (7 * 4.0) + ((daysLate - 14) * 6.0);
-            }
-        } else {
-            trans->fine = 0.0;
-        }
+int mainMenu() {
+    printHeader("MAIN MENU");
+    
+    printf("1. Admin Login\n");
+    printf("2. Member Portal\n");
+    printf("3. Exit\n");
+    printf("\nChoice: ");
+    
+    int choice;
+    scanf("%d", &choice);
+    
+    switch (choice) {
+        case 1: {
+            char username[50], password[50];
+            
+            printHeader("ADMIN LOGIN");
+            printf("Username: ");
+            scanf("%s", username);
+            printf("Password: ");
+            scanf("%s", password);
+            
+            if (verifyAdmin(username, password)) {
+                printf("\n✓ Login successful!\n");
+                pauseScreen();
+                adminMenu();
+            } else {
+                printf("\n✗ Invalid credentials!\n");
+                pauseScreen();
+            }
+            break;
+        }
+        case 2: {
+            int memberID;
+            printHeader("MEMBER PORTAL");
+            printf("Enter Member ID: ");
+            scanf("%d", &memberID);
+            
+            int found = -1;
+            for (int i = 0; i < memberCount; i++) {
+                if (members[i].memberID == memberID && members[i].isActive) {
+                    found = i;
+                    break;
+                }
+            }
+            
+            if (found != -1) {
+                printf("\n✓ Welcome, %s!\n", members[found].name);
+                pauseScreen();
+                
+                while (1) {
+                    printHeader("MEMBER DASHBOARD");
+                    printf("Member: %s (ID: %d)\n", members[found].name, memberID);
+                    printf("Accrued Fines (open loans): Rs. %.2f\n\n",
+                           accruedFinesForMember(memberID, libraryNow()));
+                    
+                    int borrows = analytics.memberBorrows[found];
+                    if (borrows > 0) {
+                        int lastBook = findBookSlot(
+                            analytics.recentBorrows[found][(borrows - 1) % RECENT_BORROWS]);
+                        if (lastBook != -1) {
+                            renderBegin(stdout, RENDER_TABLE);
+                            if (renderRecommendations(lastBook, found, RECOMMEND_SHOWN) > 0) {
+                                renderf("\n");
+                            }
+                            renderEnd();
+                        }
+                    }
+                    
+                    printf("1. View My Issued Books\n");
+                    printf("2. View Transaction History\n");
+                    printf("3. Search Books\n");
+                    printf("4. Place Hold\n");
+                    printf("5. My Holds\n");
+                    printf("6. Logout\n");
+                    printf("\nChoice: ");
+                    
+                    int memberChoice;
+                    scanf("%d", &memberChoice);
+                    
+                    switch (memberChoice) {
+                        case 1: {
+                            printHeader("MY ISSUED BOOKS");
+                            
+                            renderBegin(stdout, RENDER_TABLE);
+                            int count = renderMemberLoans(memberID, libraryNow());
+                            renderEnd();
+                            
+                            if (count == 0) {
+                                printf("No books currently issued.\n");
+                            }
+                            
+                            pauseScreen();
+                            break;
+                        }
+                        case 2:
+                            viewMemberHistory(memberID);
+                            break;
+                        case 3:
+                            searchBook();
+                            break;
+                        case 4:
+                            placeHoldMenu(memberID);
+                            break;
+                        case 5:
+                            viewMyHolds(memberID);
+                            break;
+                        case 6:
+                            printf("\n✓ Logged out!\n");
+                            pauseScreen();
+                            goto member_exit;
+                        default:
+                            printf("\n✗ Invalid choice!\n");
+                            pauseScreen();
+                    }
+                }
+                member_exit:;
+            } else {
+                printf("\n✗ Member ID not found!\n");
+                printOwningBranch("Member", branchForMemberID(memberID));
+                pauseScreen();
+            }
+            break;
+        }
+        case 3:
+            return 3;
+        default:
+            printf("\n✗ Invalid choice!\n");
+            pauseScreen();
+    }
+    
+    return 0;
+}
+
+int openEventRing() {
+    eventFile = fopen(dataPath(EVENTS_FILE), "r+b");
+    if (eventFile != NULL &&
+        fread(&eventHeader, sizeof(EventRingHeader), 1, eventFile) == 1 &&
+        eventHeader.magic == EVENT_MAGIC && eventHeader.capacity == EVENT_RING_SIZE) {
+        return 1;
     }
+    
+    if (eventFile != NULL) fclose(eventFile);
+    eventFile = fopen(dataPath(EVENTS_FILE), "w+b");
+    if (eventFile == NULL) return 0;
+    
+    eventHeader.magic = EVENT_MAGIC;
+    eventHeader.capacity = EVENT_RING_SIZE;
+    eventHeader.nextSequence = 1;
+    fwrite(&eventHeader, sizeof(EventRingHeader), 1, eventFile);
+    fflush(eventFile);
+    return 1;
 }
 
-void issueBook() {
-    printHeader("ISSUE BOOK");
+void emitEvent(int type, int bookID, int memberID, int transactionID, float amount) {
+    if (eventFile == NULL && !openEventRing()) return;
+    
+    Event event;
+    memset(&event, 0, sizeof(event));
+    event.sequence = eventHeader.nextSequence;
+    event.timestamp = (long long)libraryNow();
+    event.type = type;
+    event.bookID = bookID;
+    event.memberID = memberID;
+    event.transactionID = transactionID;
+    event.amount = amount;
+    
+    long slot = (long)(event.sequence % EVENT_RING_SIZE);
+    fseek(eventFile, (long)sizeof(EventRingHeader) + slot * (long)sizeof(Event), SEEK_SET);
+    fwrite(&event, sizeof(Event), 1, eventFile);
+    
+    eventHeader.nextSequence++;
+    fseek(eventFile, 0, SEEK_SET);
+    fwrite(&eventHeader, sizeof(EventRingHeader), 1, eventFile);
+    fflush(eventFile);
+}
+
+long long readEvents(long long from, Event *out, int max, int *count, long long *oldest) {
+    EventRingHeader header;
+    *count = 0;
+    *oldest = 1;
     
-    int bookID, memberID;
+    FILE *file = fopen(dataPath(EVENTS_FILE), "rb");
+    if (file == NULL) return from;
     
-    printf("Enter Book ID: ");
-    scanf("%d", &bookID);
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        header.magic != EVENT_MAGIC || header.capacity != EVENT_RING_SIZE) {
+        fclose(file);
+        return from;
+    }
     
-    printf("Enter Member ID: ");
-    scanf("%d", &memberID);
+    *oldest = header.nextSequence > EVENT_RING_SIZE ? header.nextSequence - EVENT_RING_SIZE : 1;
+    long long sequence = from < *oldest ? *oldest : from;
     
-    int bookIndex = -1;
-    for (int i = 0; i < bookCount; i++) {
-        if (books[i].bookID == bookID && books[i].isActive) {
-            bookIndex = i;
+    for (; sequence < header.nextSequence && *count < max; sequence++) {
+        Event *event = &out[*count];
+        fseek(file, (long)sizeof(EventRingHeader) +
+                    (long)(sequence % EVENT_RING_SIZE) * (long)sizeof(Event), SEEK_SET);
+        if (fread(event, sizeof(Event), 1, file) != 1 || event->sequence != sequence) {
             break;
         }
+        (*count)++;
     }
-    
-    if (bookIndex == -1) {
-        printf("\n✗ Book not found!\n");
-        pauseScreen();
-        return;
+    fclose(file);
+    return sequence;
+}
+
+int renderEvents(long long from, int follow) {
+    static const char *typeNames[EVENT_TYPE_COUNT] = {
+        "book_added", "book_updated", "book_deleted",
+        "member_added", "member_updated", "member_deleted",
+        "book_issued", "book_returned"
+    };
+    static Event batch[EVENT_BATCH];
+    int total = 0;
+    
+    if (renderMode == RENDER_TSV) {
+        renderf("sequence\ttime\ttype\tbook\tmember\ttransaction\tamount\n");
+    } else {
+        renderf("%-8s %-20s %-15s %-8s %-8s %-8s %-8s\n",
+                "Seq", "Time", "Type", "Book", "Member", "Trans", "Amount");
+        renderf("────────────────────────────────────────────────────────────────────────────────\n");
     }
     
-    if (books[bookIndex].availableCopies <= 0) {
-        printf("\n✗ Book not available! All copies issued.\n");
-        pauseScreen();
-        return;
+    while (1) {
+        int count;
+        long long oldest;
+        long long next = readEvents(from, batch, EVENT_BATCH, &count, &oldest);
+        
+        if (from < oldest && from > 0) {
+            fprintf(stderr, "events %lld-%lld were overwritten\n", from, oldest - 1);
+        }
+        
+        for (int i = 0; i < count; i++) {
+            Event *event = &batch[i];
+            time_t when = (time_t)event->timestamp;
+            char timeStr[20];
+            strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localtime(&when));
+            const char *type = event->type >= 0 && event->type < EVENT_TYPE_COUNT
+                             ? typeNames[event->type] : "unknown";
+            
+            if (renderMode == RENDER_TSV) {
+                renderf("%lld\t%s\t%s\t%d\t%d\t%d\t%.2f\n", event->sequence, timeStr, type,
+                        event->bookID, event->memberID, event->transactionID, event->amount);
+            } else {
+                renderf("%-8lld %-20s %-15s %-8d %-8d %-8d %.2f\n", event->sequence, timeStr,
+                        type, event->bookID, event->memberID, event->transactionID,
+                        event->amount);
+            }
+        }
+        total += count;
+        from = next;
+        
+        if (count == EVENT_BATCH) continue;
+        if (!follow) break;
+        
+        renderFlush();
+        #ifdef _WIN32
+            Sleep(1000);
+        #else
+            sleep(1);
+        #endif
     }
     
-    int memberIndex = -1;
-    for (int i = 0; i < memberCount; i++) {
-        if (members[i].memberID == memberID && members[i].isActive) {
-            memberIndex = i;
-            break;
+    fprintf(stderr, "next sequence: %lld\n", from > 0 ? from : 1);
+    return total;
+}
+
+void renderPut(const char *text, int length) {
+    if (RENDER_BUFFER_SIZE - renderLength < length) {
+        renderFlush();
+    }
+    memcpy(renderBuffer + renderLength, text, length);
+    renderLength += length;
+}
+
+void exportField(const char *name, const char *value, int quoted) {
+    char field[RENDER_LINE_MAX];
+    int n = 0;
+    
+    if (renderMode == RENDER_JSONL) {
+        n += sprintf(field, "%s\"%s\":", exportColumn == 0 ? "{" : ",", name);
+        if (value == NULL) {
+            n += sprintf(field + n, "null");
+        } else if (!quoted) {
+            n += sprintf(field + n, "%s", value);
+        } else {
+            field[n++] = '"';
+            for (const char *c = value; *c && n < RENDER_LINE_MAX - 8; c++) {
+                if (*c == '"' || *c == '\\') {
+                    field[n++] = '\\';
+                    field[n++] = *c;
+                } else if ((unsigned char)*c < 0x20) {
+                    n += sprintf(field + n, "\\u%04x", (unsigned char)*c);
+                } else {
+                    field[n++] = *c;
+                }
+            }
+            field[n++] = '"';
+        }
+    } else {
+        if (exportColumn > 0) field[n++] = ',';
+        if (value != NULL && quoted && strpbrk(value, ",\"\r\n") != NULL) {
+            field[n++] = '"';
+            for (const char *c = value; *c && n < RENDER_LINE_MAX - 4; c++) {
+                if (*c == '"') field[n++] = '"';
+                field[n++] = *c;
+            }
+            field[n++] = '"';
+        } else if (value != NULL) {
+            n += snprintf(field + n, RENDER_LINE_MAX - n, "%s", value);
         }
     }
     
-    if (memberIndex == -1) {
-        printf("\n✗ Member not found!\n");
-        pauseScreen();
+    exportColumn++;
+    renderPut(field, n);
+}
+
+void exportText(const char *name, const char *value) {
+    exportField(name, value, 1);
+}
+
+void exportInt(const char *name, int value) {
+    char text[16];
+    sprintf(text, "%d", value);
+    exportField(name, text, 0);
+}
+
+void exportMoney(const char *name, float value) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.2f", value);
+    exportField(name, text, 0);
+}
+
+void exportDate(const char *name, time_t date) {
+    char text[12];
+    if (date == 0) {
+        exportField(name, NULL, 1);
         return;
     }
-    
-    if (members[memberIndex].booksIssued >= 3) {
-        printf("\n✗ Member has already issued maximum books (3)!\n");
-        pauseScreen();
-        return;
+    formatDate(date, text);
+    exportField(name, text, 1);
+}
+
+void exportEndRow() {
+    if (renderMode == RENDER_JSONL) {
+        renderPut("}\n", 2);
+    } else {
+        renderPut("\n", 1);
     }
-    
-    if (transactionCount >= MAX_TRANSACTIONS) {
-        printf("\n✗ Transaction limit reached!\n");
-        pauseScreen();
-        return;
+    exportColumn = 0;
+}
+
+float simulationRandom() {
+    return (float)rand() / ((float)RAND_MAX + 1.0f);
+}
+
+float simulationExponential(float mean) {
+    return -mean * logf(1.0f - simulationRandom());
+}
+
+int compareSimulationEvents(const void *a, const void *b) {
+    const SimulationEvent *x = a, *y = b;
+    return (x->when > y->when) - (x->when < y->when);
+}
+
+long libraryFileSize(const char *file) {
+    struct stat info;
+    return stat(dataPath(file), &info) == 0 ? (long)info.st_size : 0;
+}
+
+int checkpointSimulation(time_t *plannedReturn, time_t now) {
+    static int remap[MAX_TRANSACTIONS];
+    FILE *history = fopen(SIMULATION_HISTORY_FILE, "ab");
+    if (history == NULL) return 0;
+    
+    int kept = 0;
+    for (int t = 0; t < transactionCount; t++) {
+        if (transactions[t].isReturned) {
+            fwrite(&transactions[t], sizeof(Transaction), 1, history);
+            remap[t] = -1;
+            continue;
+        }
+        remap[t] = kept;
+        plannedReturn[kept] = plannedReturn[t];
+        transactions[kept++] = transactions[t];
+    }
+    fclose(history);
+    
+    int rolled = transactionCount - kept;
+    transactionCount = kept;
+    for (int slot = 0; slot < bookCount; slot++) {
+        for (int c = 0; c < copyRows[slot].count; c++) {
+            if (copyRows[slot].items[c].status == COPY_ON_LOAN) {
+                copyRows[slot].items[c].loan = remap[copyRows[slot].items[c].loan];
+            }
+        }
     }
     
-    Transaction newTrans;
-    newTrans.transactionID = generateTransactionID();
-    newTrans.bookID = bookID;
-    newTrans.memberID = memberID;
-    newTrans.issueDate = time(NULL);
-    newTrans.dueDate = newTrans.issueDate + (MAX_BORROW_DAYS * 24 * 60 * 60);
-    newTrans.returnDate = 0;
-    newTrans.fine = 0.0;
-    newTrans.isReturned = 0;
-    
-    transactions[transactionCount++] = newTrans;
-    books[bookIndex].availableCopies--;
-    members[memberIndex].booksIssued++;
-    
+    rebuildTemporalIndex();
+    rebuildReminders(now);
     saveTransactions();
-    saveBooks();
-    saveMembers();
-    
-    char issueStr[26], dueStr[26];
-    strftime(issueStr, 26, "%Y-%m-%d", localtime(&newTrans.issueDate));
-    strftime(dueStr, 26, "%Y-%m-%d", localtime(&newTrans.dueDate));
-    
-    printf("\n✓ Book issued successfully!\n");
-    printf("─────────────────────────────\n");
-    printf("Transaction ID : %d\n", newTrans.transactionID);
-    printf("Book           : %s\n", books[bookIndex].title);
-    printf("Member         : %s\n", members[memberIndex].name);
-    printf("Issue Date     : %s\n", issueStr);
-    printf("Due Date       : %s\n", dueStr);
-    printf("─────────────────────────────\n");
-    printf("Note: Please return within %d days to avoid fine.\n", MAX_BORROW_DAYS);
-    
-    pauseScreen();
+    saveCopies();
+    saveReminders();
+    return rolled;
 }
 
-void returnBook() {
-    printHeader("RETURN BOOK");
-    
-    int transID;
-    printf("Enter Transaction ID: ");
-    scanf("%d", &transID);
+int renderSimulation(const SimulationConfig *config) {
+    static SimulationEvent events[MAX_MEMBERS + MAX_TRANSACTIONS];
+    static time_t plannedReturn[MAX_TRANSACTIONS];
+    static int openIndex[MAX_TRANSACTIONS];
+    static float openFines[MAX_TRANSACTIONS];
+    static const char *categories[] = {"Fiction", "Science", "History", "Children", "Reference", "Poetry"};
     
-    int transIndex = -1;
-    for (int i = 0; i < transactionCount; i++) {
-        if (transactions[i].transactionID == transID && !transactions[i].isReturned) {
-            transIndex = i;
-            break;
-        }
+    #ifdef _WIN32
+        _mkdir(SIMULATION_DIR);
+        int entered = _chdir(SIMULATION_DIR) == 0;
+    #else
+        mkdir(SIMULATION_DIR, 0755);
+        int entered = chdir(SIMULATION_DIR) == 0;
+    #endif
+    if (!entered) {
+        fprintf(stderr, "Could not enter %s/\n", SIMULATION_DIR);
+        return 0;
     }
-    
-    if (transIndex == -1) {
-        printf("\n✗ Transaction not found or book already returned!\n");
-        pauseScreen();
-        return;
+    currentBranch = 0;
+    for (size_t f = 0; f < sizeof(libraryFiles) / sizeof(libraryFiles[0]); f++) {
+        remove(libraryFiles[f]);
     }
+    remove(SIMULATION_HISTORY_FILE);
     
-    transactions[transIndex].returnDate = time(NULL);
-    transactions[transIndex].isReturned = 1;
-    
-    calculateFine(&transactions[transIndex]);
-    
-    int bookIndex = -1, memberIndex = -1;
+    time_t start = libraryNow();
+    virtualClock = start;
+    srand(config->seed);
+    loadLibrary();
     
+    bookCount = config->titles;
     for (int i = 0; i < bookCount; i++) {
-        if (books[i].bookID == transactions[transIndex].bookID) {
-            bookIndex = i;
-            break;
-        }
+        Book *book = &books[i];
+        memset(book, 0, sizeof(Book));
+        book->bookID = 1001 + i;
+        snprintf(book->title, MAX_STRING, "Simulated Title %d", i + 1);
+        snprintf(book->author, MAX_STRING, "Author %d", i % 97 + 1);
+        snprintf(book->ISBN, sizeof(book->ISBN), "SIM-%06d", i + 1);
+        strcpy(book->category, categories[i % 6]);
+        book->totalCopies = book->availableCopies = 1 + rand() % 4;
+        book->price = (float)(100 + rand() % 900);
+        book->isActive = 1;
     }
-    
+    memberCount = config->members;
     for (int i = 0; i < memberCount; i++) {
-        if (members[i].memberID == transactions[transIndex].memberID) {
-            memberIndex = i;
-            break;
-        }
-    }
-    
-    if (bookIndex != -1) {
-        books[bookIndex].availableCopies++;
+        Member *member = &members[i];
+        memset(member, 0, sizeof(Member));
+        member->memberID = 2001 + i;
+        snprintf(member->name, MAX_STRING, "Patron %d", i + 1);
+        snprintf(member->email, MAX_STRING, "patron%d@example.org", i + 1);
+        member->isActive = 1;
     }
-    
-    if (memberIndex != -1) {
-        members[memberIndex].booksIssued--;
-        members[memberIndex].totalFines += transactions[transIndex].fine;
+    rebuildIDIndexes();
+    rebuildPolicyClasses();
+    rebuildOrderIndexes();
+    rebuildBTrees();
+    rebuildTermIndex();
+    for (int i = 0; i < bookCount; i++) {
+        resetCopyRow(i);
+        syncCopies(i);
     }
-    
-    saveTransactions();
     saveBooks();
     saveMembers();
+    saveCopies();
+    rebuildAnalytics();
+    saveAnalytics();
     
-    char returnStr[26];
-    strftime(returnStr, 26, "%Y-%m-%d", localtime(&transactions[transIndex].returnDate));
-    
-    printf("\n✓ Book returned successfully!\n");
-    printf("─────────────────────────────\n");
-    printf("Transaction ID : %d\n", transactions[transIndex].transactionID);
-    if (bookIndex != -1) {
-        printf("Book           : %s\n", books[bookIndex].title);
-    }
-    if (memberIndex != -1) {
-        printf("Member         : %s\n", members[memberIndex].name);
-    }
-    printf("Return Date    : %s\n", returnStr);
-    
-    if (transactions[transIndex].fine > 0) {
-        printf("\n⚠ FINE: Rs. %.2f\n", transactions[transIndex].fine);
-        printf("  (Late by %d days)\n", 
-               getDaysDifference(transactions[transIndex].dueDate, 
-                               transactions[transIndex].returnDate));
-    } else {
-        printf("\n✓ Returned on time. No fine!\n");
+    long startSizes[sizeof(libraryFiles) / sizeof(libraryFiles[0])];
+    for (size_t f = 0; f < sizeof(libraryFiles) / sizeof(libraryFiles[0]); f++) {
+        startSizes[f] = libraryFileSize(libraryFiles[f]);
     }
     
-    pauseScreen();
-}
-
-void viewIssuedBooks() {
-    printHeader("CURRENTLY ISSUED BOOKS");
-    
-    int issuedCount = 0;
+    int issues = 0, returns = 0, unavailable = 0, limited = 0, holdsPlaced = 0;
+    int lateReturns = 0, openLoans = 0, peakLoans = 0, fullDay = 0;
+    int checkpoints = 0, rolled = 0;
+    float finesCharged = 0;
+    time_t peakWhen = start;
     
-    printf("%-8s %-30s %-20s %-12s %-12s\n",
-           "Trans ID", "Book Title", "Member Name", "Issue Date", "Due Date");
-    printf("────────────────────────────────────────────────────────────────────────────────\n");
+    struct timespec began, ended;
+    timespec_get(&began, TIME_UTC);
     
-    for (int i = 0; i < transactionCount; i++) {
-        if (!transactions[i].isReturned) {
-            char bookTitle[MAX_STRING] = "Unknown";
-            char memberName[MAX_STRING] = "Unknown";
-            
-            for (int j = 0; j < bookCount; j++) {
-                if (books[j].bookID == transactions[i].bookID) {
-                    strcpy(bookTitle, books[j].title);
-                    break;
-                }
+    int day;
+    for (day = 0; day < config->days && fullDay == 0; day++) {
+        time_t dayStart = start + (time_t)day * SECONDS_PER_DAY;
+        int count = 0;
+        
+        if (transactionCount + memberCount > MAX_TRANSACTIONS) {
+            rolled += checkpointSimulation(plannedReturn, dayStart);
+            checkpoints++;
+        }
+        
+        for (int m = 0; m < memberCount; m++) {
+            if (simulationRandom() < config->arrivalRate) {
+                events[count].when = dayStart + rand() % SECONDS_PER_DAY;
+                events[count].memberIndex = m;
+                events[count].transIndex = -1;
+                count++;
             }
+        }
+        for (int t = 0; t < transactionCount; t++) {
+            if (!transactions[t].isReturned && plannedReturn[t] < dayStart + SECONDS_PER_DAY) {
+                events[count].when = plannedReturn[t] > dayStart ? plannedReturn[t] : dayStart;
+                events[count].memberIndex = -1;
+                events[count].transIndex = t;
+                count++;
+            }
+        }
+        qsort(events, count, sizeof(SimulationEvent), compareSimulationEvents);
+        
+        for (int e = 0; e < count && fullDay == 0; e++) {
+            time_t now = events[e].when;
+            virtualClock = now;
             
-            for (int j = 0; j < memberCount; j++) {
-                if (members[j].memberID == transactions[i].memberID) {
-                    strcpy(memberName, members[j].name);
-                    break;
+            if (events[e].transIndex != -1) {
+                Transaction *trans = &transactions[events[e].transIndex];
+                performReturn(events[e].transIndex, now);
+                returns++;
+                openLoans--;
+                if (trans->fine > 0) {
+                    lateReturns++;
+                    finesCharged += trans->fine;
                 }
+                continue;
             }
             
-            char issueStr[12], dueStr[12];
-            strftime(issueStr, 12, "%Y-%m-%d", localtime(&transactions[i].issueDate));
-            strftime(dueStr, 12, "%Y-%m-%d", localtime(&transactions[i].dueDate));
-            
-            printf("%-8d %-30s %-20s %-12s %-12s",
-                   transactions[i].transactionID, bookTitle, memberName,
-                   issueStr, dueStr);
-            
-            time_t now = time(NULL);
-            if (now > transactions[i].dueDate) {
-                int daysOverdue = getDaysDifference(transactions[i].dueDate, now);
-                printf(" ⚠ OVERDUE (%d days)", daysOverdue);
+            int memberIndex = events[e].memberIndex;
+            int bookIndex = -1;
+            for (int h = memberHoldHead[memberIndex]; h != -1 && bookIndex == -1; h = memberHoldNext[h]) {
+                if (holds[h].status == HOLD_READY) bookIndex = findBookSlot(holds[h].bookID);
+            }
+            if (bookIndex == -1) {
+                bookIndex = (int)(bookCount * powf(simulationRandom(), SIMULATION_POPULAR_SKEW));
             }
             
-            printf("\n");
-            issuedCount++;
+            int transIndex = performIssue(bookIndex, memberIndex, -1, now);
+            if (transIndex >= 0) {
+                Transaction *trans = &transactions[transIndex];
+                if (simulationRandom() < config->lateShare) {
+                    plannedReturn[transIndex] = trans->dueDate + SECONDS_PER_DAY +
+                        (time_t)(simulationExponential(config->lateDays) * SECONDS_PER_DAY);
+                } else {
+                    plannedReturn[transIndex] = now +
+                        (time_t)(simulationExponential(config->keepDays) * SECONDS_PER_DAY);
+                    if (plannedReturn[transIndex] > trans->dueDate) {
+                        plannedReturn[transIndex] = trans->dueDate;
+                    }
+                }
+                issues++;
+                if (++openLoans > peakLoans) {
+                    peakLoans = openLoans;
+                    peakWhen = now;
+                }
+            } else if (transIndex == ISSUE_UNAVAILABLE) {
+                unavailable++;
+                if (simulationRandom() < SIMULATION_HOLD_SHARE &&
+                    placeHold(bookIndex, memberIndex, now) != -1) {
+                    saveHolds();
+                    holdsPlaced++;
+                }
+            } else if (transIndex == ISSUE_LIMIT_REACHED) {
+                limited++;
+            } else {
+                fullDay = day + 1;
+            }
         }
     }
     
-    printf("\nTotal Issued Books: %d\n", issuedCount);
-    pauseScreen();
+    timespec_get(&ended, TIME_UTC);
+    double elapsed = (double)(ended.tv_sec - began.tv_sec) +
+                     (double)(ended.tv_nsec - began.tv_nsec) / 1e9;
+    time_t end = start + (time_t)day * SECONDS_PER_DAY;
+    virtualClock = end;
+    
+    float finesAccrued = 0;
+    int open = accrueOpenFines(end, openIndex, openFines);
+    for (int i = 0; i < open; i++) {
+        finesAccrued += openFines[i];
+    }
+    
+    char fromStr[12], toStr[12], peakStr[12];
+    formatDate(start, fromStr);
+    formatDate(end, toStr);
+    formatDate(peakWhen, peakStr);
+    int operations = issues + returns + unavailable + limited;
+    
+    renderf("Simulated %d day(s), %s to %s, in %.2f s\n", day, fromStr, toStr, elapsed);
+    renderf("Population       : %d members, %d titles\n", memberCount, bookCount);
+    renderf("Issues           : %d\n", issues);
+    renderf("Returns          : %d (%d late)\n", returns, lateReturns);
+    renderf("Refused          : %d no copy, %d at borrowing limit\n", unavailable, limited);
+    renderf("Holds placed     : %d\n", holdsPlaced);
+    if (checkpoints > 0) {
+        renderf("Checkpoints      : %d (%d returned loan(s) moved to %s)\n",
+                checkpoints, rolled, SIMULATION_HISTORY_FILE);
+    }
+    renderf("Throughput       : %.0f operations/s, %.1f simulated days/s\n",
+            elapsed > 0 ? operations / elapsed : 0.0, elapsed > 0 ? day / elapsed : 0.0);
+    renderf("Peak open loans  : %d on %s\n", peakLoans, peakStr);
+    renderf("Fines charged    : Rs. %.2f\n", finesCharged);
+    renderf("Fines accrued    : Rs. %.2f on %d open loan(s)\n", finesAccrued, open);
+    if (fullDay != 0) {
+        renderf("Transaction log  : full (%d entries) on day %d\n", MAX_TRANSACTIONS, fullDay);
+    }
+    
+    renderf("\n%-18s %12s %12s\n", "File", "Start (KB)", "End (KB)");
+    renderf("──────────────────────────────────────────────\n");
+    long startTotal = 0, endTotal = 0;
+    for (size_t f = 0; f < sizeof(libraryFiles) / sizeof(libraryFiles[0]); f++) {
+        long size = libraryFileSize(libraryFiles[f]);
+        renderf("%-18s %12.1f %12.1f\n", libraryFiles[f], startSizes[f] / 1024.0, size / 1024.0);
+        startTotal += startSizes[f];
+        endTotal += size;
+    }
+    long historySize = libraryFileSize(SIMULATION_HISTORY_FILE);
+    if (historySize > 0) {
+        renderf("%-18s %12.1f %12.1f\n", SIMULATION_HISTORY_FILE, 0.0, historySize / 1024.0);
+        endTotal += historySize;
+    }
+    renderf("%-18s %12.1f %12.1f\n", "Total", startTotal / 1024.0, endTotal / 1024.0);
+    renderf("\nSimulation data is in %s/\n", SIMULATION_DIR);
+    return 1;
 }
 
-void viewMemberHistory(int memberID) {
-    printHeader("MEMBER TRANSACTION HISTORY");
+int verifyChecksums(int table) {
+    ChecksumSet stored;
+    int version = 0;
+    FILE *file = fopen(dataPath(CHECKSUMS_FILE), "rb");
+    int recorded = file != NULL && fread(&version, sizeof(int), 1, file) == 1 &&
+                   version == CHECKSUMS_VERSION &&
+                   fseek(file, (long)(table * sizeof(ChecksumSet)), SEEK_CUR) == 0 &&
+                   fread(&stored, sizeof(ChecksumSet), 1, file) == 1 &&
+                   stored.rows != CHECKSUMS_UNRECORDED;
+    if (file != NULL) fclose(file);
+    
+    const char *name = checkedFiles[table];
+    file = fopen(dataPath(name), "rb");
+    if (file == NULL) {
+        if (recorded && stored.rows > 0) {
+            renderf("%-18s missing, expected %d row(s)\n", name, stored.rows);
+            return 1;
+        }
+        renderf("%-18s not created yet\n", name);
+        return 0;
+    }
     
-    printf("Member ID: %d\n\n", memberID);
+    int header = 0, rows = 0;
+    if (table != CHECKED_BOOKS) {
+        fread(&header, sizeof(int), 1, file);
+    }
+    if ((table == CHECKED_TRANSACTIONS && header != -TRANSACTIONS_VERSION) ||
+        (table == CHECKED_MEMBERS && header >= 0)) {
+        fclose(file);
+        renderf("%-18s older format without checksums, upgraded on the next save\n", name);
+        return 0;
+    }
+    if ((table == CHECKED_COPIES && header != COPIES_VERSION) ||
+        fread(&rows, sizeof(int), 1, file) != 1 || rows < 0 || rows > checkedRowLimits[table]) {
+        fclose(file);
+        renderf("%-18s unreadable header\n", name);
+        return 1;
+    }
     
-    printf("%-8s %-30s %-12s %-12s %-10s %-10s\n",
-           "Trans ID", "Book", "Issue Date", "Return Date", "Status", "Fine");
-    printf("────────────────────────────────────────────────────────────────────────────────\n");
+    size_t rowSize = checkedRowSizes[table];
+    char *data = malloc(rowSize * (rows > 0 ? rows : 1));
+    if (data == NULL) {
+        fclose(file);
+        renderf("%-18s not checked, out of memory\n", name);
+        return 0;
+    }
+    int read = (int)fread(data, rowSize, rows, file);
+    fclose(file);
     
-    int count = 0;
-    for (int i = 0; i < transactionCount; i++) {
-        if (transactions[i].memberID == memberID) {
-            char bookTitle[MAX_STRING] = "Unknown";
-            
-            for (int j = 0; j < bookCount; j++) {
-                if (books[j].bookID == transactions[i].bookID) {
-                    strcpy(bookTitle, books[j].title);
-                    break;
-                }
-            }
-            
-            char issueStr[12], returnStr[12];
-            strftime(issueStr, 12, "%Y-%m-%d", localtime(&transactions[i].issueDate));
-            
-            if (transactions[i].isReturned) {
-                strftime(returnStr, 12, "%Y-%m-%d", localtime(&transactions[i].returnDate));
-            } else {
-                strcpy(returnStr, "Not Yet");
-            }
-            
-            printf("%-8d %-30s %-12s %-12s %-10s Rs. %.2f\n",
-                   transactions[i].transactionID, bookTitle, issueStr, returnStr,
-                   transactions[i].isReturned ? "Returned" : "Issued",
-                   transactions[i].fine);
-            count++;
+    int errors = 0;
+    if (read < rows) {
+        renderf("%-18s truncated: %d of %d row(s)\n", name, read, rows);
+        errors++;
+    }
+    if (!recorded) {
+        renderf("%-18s %d row(s), no checksums recorded yet\n", name, read);
+        free(data);
+        return errors;
+    }
+    if (stored.rows != rows) {
+        renderf("%-18s holds %d row(s), checksums were recorded for %d\n", name, rows, stored.rows);
+        errors++;
+    }
+    
+    int blocks = (read + CHECKSUM_BLOCK_ROWS - 1) / CHECKSUM_BLOCK_ROWS;
+    int badBlocks = 0;
+    for (int block = 0; block < blocks && stored.rows == rows; block++) {
+        int start = block * CHECKSUM_BLOCK_ROWS;
+        int end = start + CHECKSUM_BLOCK_ROWS < read ? start + CHECKSUM_BLOCK_ROWS : read;
+        if (blockChecksum(data + start * rowSize, (end - start) * rowSize) != stored.sums[block]) {
+            renderf("%-18s block %d (rows %d-%d) checksum mismatch\n", name, block, start + 1, end);
+            badBlocks++;
         }
     }
+    free(data);
     
-    if (count == 0) {
-        printf("No transaction history found.\n");
+    if (errors == 0 && badBlocks == 0) {
+        renderf("%-18s %d row(s) in %d block(s), ok\n", name, read, blocks);
     }
-    
-    pauseScreen();
+    return errors + badBlocks;
 }
 
-void transactionMenu() {
-    while (1) {
-        printHeader("TRANSACTION MANAGEMENT");
+void *aggregatePartition(void *arg) {
+    FsckPartition *part = arg;
+    
+    for (int i = part->from; i < part->to; i++) {
+        const Transaction *trans = &transactions[i];
+        int bookIndex = findBookSlot(trans->bookID);
+        int memberIndex = findMemberSlot(trans->memberID);
         
-        printf("1. Issue Book\n");
-        printf("2. Return Book\n");
-        printf("3. View Currently Issued Books\n");
-        printf("4. View Member History\n");
-        printf("5. Back to Main Menu\n");
-        printf("\nChoice: ");
+        if (bookIndex == -1 && archivedBook(trans->bookID) == NULL) part->unknownBooks++;
+        if (memberIndex == -1 && archivedMember(trans->memberID) == NULL) part->unknownMembers++;
+        if (trans->dueDate < trans->issueDate ||
+            (trans->isReturned && trans->returnDate < trans->issueDate)) {
+            part->badDates++;
+        }
         
-        int choice;
-        scanf("%d", &choice);
+        if (trans->isReturned) {
+            if (memberIndex != -1) part->memberFines[memberIndex] += trans->fine;
+            continue;
+        }
+        if (memberIndex != -1) part->memberLoans[memberIndex]++;
+        if (bookIndex == -1) continue;
         
-        switch (choice) {
-            case 1: issueBook(); break;
-            case 2: returnBook(); break;
-            case 3: viewIssuedBooks(); break;
-            case 4: {
-                int memberID;
-                printf("\nEnter Member ID: ");
-                scanf("%d", &memberID);
-                viewMemberHistory(memberID);
-                break;
-            }
-            case 5: return;
-            default:
-                printf("\n✗ Invalid choice!\n");
-                pauseScreen();
+        part->bookLoans[bookIndex]++;
+        int copy = -1;
+        if (findCopy(trans->copyBarcode, &copy) != bookIndex ||
+            copyRows[bookIndex].items[copy].status != COPY_ON_LOAN ||
+            copyRows[bookIndex].items[copy].loan != i) {
+            part->bookStrays[bookIndex]++;
         }
     }
+    return NULL;
 }
 
-void displayMenuRecursive(int menuType) {
-    if (menuType == 0) return;
+int repairCounters(const FsckPartition *totals) {
+    int transChanged = 0;
+    int fixed = 0;
+    
+    for (int slot = 0; slot < bookCount; slot++) {
+        CopyRow *row = &copyRows[slot];
+        for (int c = 0; c < row->count; c++) {
+            int loan = row->items[c].loan;
+            if (row->items[c].status == COPY_ON_LOAN &&
+                (loan < 0 || loan >= transactionCount || transactions[loan].isReturned ||
+                 transactions[loan].copyBarcode != row->items[c].barcode)) {
+                setCopyStatus(slot, c, books[slot].isActive ? COPY_AVAILABLE : COPY_WITHDRAWN);
+                fixed++;
+            }
+        }
+    }
     
-    if (menuType == 1) {
-        printf("→ Admin Menu\n");
-    } else if (menuType == 2) {
-        printf("  → Book Management\n");
-    } else if (menuType == 3) {
-        printf("    → View Books\n");
+    for (int i = 0; i < transactionCount; i++) {
+        Transaction *trans = &transactions[i];
+        int slot = trans->isReturned ? -1 : findBookSlot(trans->bookID);
+        if (slot == -1 || totals->bookStrays[slot] == 0) continue;
+        
+        int copy = -1;
+        if (findCopy(trans->copyBarcode, &copy) != slot ||
+            (copyRows[slot].items[copy].status == COPY_ON_LOAN && copyRows[slot].items[copy].loan != i)) {
+            copy = takeCopy(slot, COPY_AVAILABLE);
+            if (copy == -1) copy = takeCopy(slot, COPY_RESERVED);
+            if (copy == -1) copy = addCopy(slot);
+            if (copy == -1) continue;
+            trans->copyBarcode = copyRows[slot].items[copy].barcode;
+            transChanged = 1;
+        }
+        setCopyStatus(slot, copy, COPY_ON_LOAN);
+        copyRows[slot].items[copy].loan = i;
+        fixed++;
     }
     
-    displayMenuRecursive(menuType - 1);
+    for (int slot = 0; slot < bookCount; slot++) {
+        int circulating = __builtin_popcountll(copyAvailable[slot]) +
+                          __builtin_popcountll(copyReserved[slot]) + totals->bookLoans[slot];
+        int available = __builtin_popcountll(copyAvailable[slot]);
+        if (books[slot].totalCopies != circulating || books[slot].availableCopies != available) {
+            books[slot].totalCopies = circulating;
+            books[slot].availableCopies = available;
+            fixed++;
+        }
+    }
+    for (int m = 0; m < memberCount; m++) {
+        if (members[m].booksIssued != totals->memberLoans[m] ||
+            fabsf(members[m].totalFines - totals->memberFines[m]) > FSCK_FINE_TOLERANCE) {
+            members[m].booksIssued = totals->memberLoans[m];
+            members[m].totalFines = totals->memberFines[m];
+            fixed++;
+        }
+    }
+    
+    if (transChanged) saveTransactions();
+    saveBooks();
+    saveMembers();
+    saveCopies();
+    rebuildOrderIndexes();
+    return fixed;
 }
 
-int searchBookRecursive(int id, int left, int right) {
-    if (left > right) {
-        return -1;
+int renderFsck(int repair) {
+    static FsckPartition parts[FSCK_THREADS];
+    static FsckPartition totals;
+    
+    struct timespec began, ended;
+    timespec_get(&began, TIME_UTC);
+    
+    int blockErrors = 0;
+    for (int t = 0; t < CHECKED_TABLE_COUNT; t++) {
+        blockErrors += verifyChecksums(t);
     }
     
-    int mid = left + (right - left) / 2;
+    int span = (transactionCount + FSCK_THREADS - 1) / FSCK_THREADS;
+    for (int i = 0; i < FSCK_THREADS; i++) {
+        memset(&parts[i], 0, sizeof(FsckPartition));
+        parts[i].from = i * span < transactionCount ? i * span : transactionCount;
+        parts[i].to = (i + 1) * span < transactionCount ? (i + 1) * span : transactionCount;
+    }
+    
+    #ifdef _WIN32
+        for (int i = 0; i < FSCK_THREADS; i++) {
+            aggregatePartition(&parts[i]);
+        }
+    #else
+        pthread_t threads[FSCK_THREADS];
+        int started[FSCK_THREADS];
+        for (int i = 0; i < FSCK_THREADS; i++) {
+            started[i] = pthread_create(&threads[i], NULL, aggregatePartition, &parts[i]) == 0;
+            if (!started[i]) aggregatePartition(&parts[i]);
+        }
+        for (int i = 0; i < FSCK_THREADS; i++) {
+            if (started[i]) pthread_join(threads[i], NULL);
+        }
+    #endif
     
-    if (books[mid].bookID == id && books[mid].isActive) {
-        return mid;
+    memset(&totals, 0, sizeof(FsckPartition));
+    for (int i = 0; i < FSCK_THREADS; i++) {
+        for (int b = 0; b < bookCount; b++) {
+            totals.bookLoans[b] += parts[i].bookLoans[b];
+            totals.bookStrays[b] += parts[i].bookStrays[b];
+        }
+        for (int m = 0; m < memberCount; m++) {
+            totals.memberLoans[m] += parts[i].memberLoans[m];
+            totals.memberFines[m] += parts[i].memberFines[m];
+        }
+        totals.unknownBooks += parts[i].unknownBooks;
+        totals.unknownMembers += parts[i].unknownMembers;
+        totals.badDates += parts[i].badDates;
     }
     
-    if (books[mid].bookID > id) {
-        return searchBookRecursive(id, left, mid - 1);
-    } else {
-        return searchBookRecursive(id, mid + 1, right);
+    int counterErrors = 0;
+    renderf("\n%-8s %-30s %-16s %8s %8s\n", "ID", "Name", "Counter", "Stored", "Log");
+    renderf("────────────────────────────────────────────────────────────────────────\n");
+    for (int b = 0; b < bookCount; b++) {
+        int reserved = __builtin_popcountll(copyReserved[b]);
+        int onLoan = 0;
+        for (int c = 0; c < copyRows[b].count; c++) {
+            if (copyRows[b].items[c].status == COPY_ON_LOAN) onLoan++;
+        }
+        int circulating = __builtin_popcountll(copyAvailable[b]) + reserved + onLoan;
+        int expected = circulating - totals.bookLoans[b] - reserved;
+        
+        if (books[b].availableCopies != expected) {
+            renderf("%-8d %-30.30s %-16s %8d %8d\n", books[b].bookID, books[b].title,
+                    "available", books[b].availableCopies, expected);
+            counterErrors++;
+        }
+        if (books[b].totalCopies != circulating) {
+            renderf("%-8d %-30.30s %-16s %8d %8d\n", books[b].bookID, books[b].title,
+                    "copies", books[b].totalCopies, circulating);
+            counterErrors++;
+        }
+        if (onLoan != totals.bookLoans[b] || totals.bookStrays[b] > 0) {
+            renderf("%-8d %-30.30s %-16s %8d %8d\n", books[b].bookID, books[b].title,
+                    "copies on loan", onLoan, totals.bookLoans[b]);
+            counterErrors++;
+        }
     }
-}
-
-int searchMemberRecursive(int id, int left, int right) {
-    if (left > right) {
-        return -1;
+    for (int m = 0; m < memberCount; m++) {
+        if (members[m].booksIssued != totals.memberLoans[m]) {
+            renderf("%-8d %-30.30s %-16s %8d %8d\n", members[m].memberID, members[m].name,
+                    "books issued", members[m].booksIssued, totals.memberLoans[m]);
+            counterErrors++;
+        }
+        if (fabsf(members[m].totalFines - totals.memberFines[m]) > FSCK_FINE_TOLERANCE) {
+            renderf("%-8d %-30.30s %-16s %8.2f %8.2f\n", members[m].memberID, members[m].name,
+                    "fines", members[m].totalFines, totals.memberFines[m]);
+            counterErrors++;
+        }
     }
     
-    int mid = left + (right - left) / 2;
+    timespec_get(&ended, TIME_UTC);
+    double elapsed = (double)(ended.tv_sec - began.tv_sec) +
+                     (double)(ended.tv_nsec - began.tv_nsec) / 1e9;
+    
+    renderf("\nChecked %d book(s), %d member(s), %d transaction(s) in %.3f ms (%d threads)\n",
+            bookCount, memberCount, transactionCount, elapsed * 1000.0, FSCK_THREADS);
+    renderf("Checksum errors  : %d\n", blockErrors);
+    renderf("Counter errors   : %d\n", counterErrors);
+    if (totals.unknownBooks > 0 || totals.unknownMembers > 0 || totals.badDates > 0) {
+        renderf("Log problems     : %d unknown book(s), %d unknown member(s), %d bad date(s)\n",
+                totals.unknownBooks, totals.unknownMembers, totals.badDates);
+    }
     
-    if (members[mid].memberID == id && members[mid].isActive) {
-        return mid;
+    if (!repair) {
+        if (blockErrors + counterErrors > 0) {
+            renderf("Run 'fsck --repair' to rebuild the counters and re-record the checksums\n");
+        }
+        return blockErrors + counterErrors == 0;
     }
     
-    if (members[mid].memberID > id) {
-        return searchMemberRecursive(id, left, mid - 1);
-    } else {
-        return searchMemberRecursive(id, mid + 1, right);
+    int fixed = repairCounters(&totals);
+    renderf("Repaired %d record(s); checksums re-recorded for the current contents\n", fixed);
+    return 1;
+}
+
+int parseExportTable(const char *name) {
+    for (int t = 0; t < EXPORT_TABLE_COUNT; t++) {
+        if (strcmp(name, exportTableNames[t]) == 0) return t;
     }
+    return -1;
 }
 
-void adminMenu() {
-    while (1) {
-        printHeader("ADMIN DASHBOARD");
-        
-        printf("1. Book Management\n");
-        printf("2. Member Management\n");
-        printf("3. Transaction Management\n");
-        printf("4. View Statistics\n");
-        printf("5. Logout\n");
-        printf("\nChoice: ");
-        
-        int choice;
-        scanf("%d", &choice);
-        
-        switch (choice) {
-            case 1:
-                bookManagementMenu();
-                break;
-            case 2:
-                memberManagementMenu();
-                break;
-            case 3:
-                transactionMenu();
-                break;
-            case 4: {
-                printHeader("LIBRARY STATISTICS");
-                
-                int activeBooks = 0, activeMembers = 0, issuedBooks = 0;
-                float totalFines = 0.0;
-                
-                for (int i = 0; i < bookCount; i++) {
-                    if (books[i].isActive) activeBooks++;
-                }
-                
-                for (int i = 0; i < memberCount; i++) {
-                    if (members[i].isActive) {
-                        activeMembers++;
-                        totalFines += members[i].totalFines;
-                    }
-                }
-                
-                for (int i = 0; i < transactionCount; i++) {
-                    if (!transactions[i].isReturned) issuedBooks++;
-                }
-                
-                printf("Total Books       : %d\n", activeBooks);
-                printf("Total Members     : %d\n", activeMembers);
-                printf("Currently Issued  : %d\n", issuedBooks);
-                printf("Total Transactions: %d\n", transactionCount);
-                printf("Total Fines       : Rs. %.2f\n", totalFines);
-                
-                pauseScreen();
-                break;
+int renderExport(int table, time_t now) {
+    static const char *headers[EXPORT_TABLE_COUNT] = {
+        "id,title,author,isbn,category,total,available,price,active\n",
+        "id,name,email,phone,address,books_issued,fines,active,tier\n",
+        "id,book,copy,member,issued,due,returned,fine,status\n",
+        "transaction,book,copy,title,author,member,name,email,issued,due,returned,status,overdue_days,fine\n"
+    };
+    int rows = 0;
+    
+    if (renderMode == RENDER_CSV) {
+        renderPut(headers[table], strlen(headers[table]));
+    }
+    exportColumn = 0;
+    
+    if (table == EXPORT_BOOKS) {
+        for (int i = 0; i < bookCount; i++, rows++) {
+            exportInt("id", books[i].bookID);
+            exportText("title", books[i].title);
+            exportText("author", books[i].author);
+            exportText("isbn", books[i].ISBN);
+            exportText("category", books[i].category);
+            exportInt("total", books[i].totalCopies);
+            exportInt("available", books[i].availableCopies);
+            exportMoney("price", books[i].price);
+            exportInt("active", books[i].isActive);
+            exportEndRow();
+        }
+    } else if (table == EXPORT_MEMBERS) {
+        for (int i = 0; i < memberCount; i++, rows++) {
+            exportInt("id", members[i].memberID);
+            exportText("name", members[i].name);
+            exportText("email", members[i].email);
+            exportText("phone", members[i].phone);
+            exportText("address", members[i].address);
+            exportInt("books_issued", members[i].booksIssued);
+            exportMoney("fines", members[i].totalFines);
+            exportInt("active", members[i].isActive);
+            exportText("tier", tierNames[members[i].tier]);
+            exportEndRow();
+        }
+    } else if (table == EXPORT_TRANSACTIONS) {
+        for (int i = 0; i < transactionCount; i++, rows++) {
+            Transaction *trans = &transactions[i];
+            exportInt("id", trans->transactionID);
+            exportInt("book", trans->bookID);
+            exportInt("copy", trans->copyBarcode);
+            exportInt("member", trans->memberID);
+            exportDate("issued", trans->issueDate);
+            exportDate("due", trans->dueDate);
+            exportDate("returned", trans->isReturned ? trans->returnDate : 0);
+            exportMoney("fine", trans->fine);
+            exportText("status", trans->isReturned ? "returned" : "issued");
+            exportEndRow();
+        }
+    } else {
+        for (int i = 0; i < transactionCount; i++, rows++) {
+            Transaction *trans = &transactions[i];
+            const Book *book = bookRecord(trans->bookID);
+            const Member *member = memberRecord(trans->memberID);
+            int overdueDays = 0;
+            float fine = trans->fine;
+            
+            if (!trans->isReturned && now > trans->dueDate) {
+                overdueDays = getDaysDifference(trans->dueDate, now);
+                fine = fineForDaysLate(transactionPolicy(trans), overdueDays);
             }
-            case 5:
-                printf("\n✓ Logged out successfully!\n");
-                pauseScreen();
-                return;
-            default:
-                printf("\n✗ Invalid choice!\n");
-                pauseScreen();
+            
+            exportInt("transaction", trans->transactionID);
+            exportInt("book", trans->bookID);
+            exportInt("copy", trans->copyBarcode);
+            exportText("title", book != NULL ? book->title : NULL);
+            exportText("author", book != NULL ? book->author : NULL);
+            exportInt("member", trans->memberID);
+            exportText("name", member != NULL ? member->name : NULL);
+            exportText("email", member != NULL ? member->email : NULL);
+            exportDate("issued", trans->issueDate);
+            exportDate("due", trans->dueDate);
+            exportDate("returned", trans->isReturned ? trans->returnDate : 0);
+            exportText("status", trans->isReturned ? "returned"
+                               : overdueDays > 0 ? "overdue" : "issued");
+            exportInt("overdue_days", overdueDays);
+            exportMoney("fine", fine);
+            exportEndRow();
         }
     }
+    
+    return rows;
 }
 
-int mainMenu() {
-    printHeader("MAIN MENU");
+void exportMenu() {
+    printHeader("EXPORT DATA");
+    
+    printf("1. Books\n");
+    printf("2. Members\n");
+    printf("3. Transactions\n");
+    printf("4. Loans (with titles and names)\n");
+    printf("\nTable: ");
+    
+    int table;
+    scanf("%d", &table);
+    if (table < 1 || table > EXPORT_TABLE_COUNT) {
+        printf("\n✗ Invalid choice!\n");
+        pauseScreen();
+        return;
+    }
+    table--;
     
-    printf("1. Admin Login\n");
-    printf("2. Member Portal\n");
-    printf("3. Exit\n");
-    printf("\nChoice: ");
+    printf("Format (1. CSV  2. JSON Lines): ");
+    int format;
+    scanf("%d", &format);
     
-    int choice;
-    scanf("%d", &choice);
+    char name[MAX_STRING], path[MAX_STRING];
+    sprintf(name, "export_%s.%s", exportTableNames[table], format == 2 ? "jsonl" : "csv");
+    strcpy(path, dataPath(name));
     
-    switch (choice) {
-        case 1: {
-            char username[50], password[50];
-            
-            printHeader("ADMIN LOGIN");
-            printf("Username: ");
-            scanf("%s", username);
-            printf("Password: ");
-            scanf("%s", password);
-            
-            if (verifyAdmin(username, password)) {
-                printf("\n✓ Login successful!\n");
-                pauseScreen();
-                adminMenu();
-            } else {
-                printf("\n✗ Invalid credentials!\n");
-                pauseScreen();
-            }
-            break;
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        printf("\n✗ Cannot create %s!\n", path);
+        pauseScreen();
+        return;
+    }
+    
+    renderBegin(out, format == 2 ? RENDER_JSONL : RENDER_CSV);
+    int rows = renderExport(table, libraryNow());
+    renderEnd();
+    fclose(out);
+    
+    printf("\n✓ Exported %d rows to %s\n", rows, path);
+    pauseScreen();
+}
+
+int runCommand(int argc, char *argv[]) {
+    int mode = RENDER_TABLE;
+    const char *order = "id";
+    int limit = 0;
+    const char *after = NULL;
+    long long from = 0;
+    int follow = 0;
+    const char *until = NULL;
+    int bookFilter = 0, memberFilter = 0;
+    const char *category = NULL;
+    
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--tsv") == 0) {
+            mode = RENDER_TSV;
+        } else if (strcmp(argv[i], "--jsonl") == 0) {
+            mode = RENDER_JSONL;
+        } else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            order = argv[++i];
+        } else if (strcmp(argv[i], "--after") == 0 && i + 1 < argc) {
+            after = argv[++i];
+        } else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            limit = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            from = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--follow") == 0) {
+            follow = 1;
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            until = argv[++i];
+        } else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc) {
+            bookFilter = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--member") == 0 && i + 1 < argc) {
+            memberFilter = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--category") == 0 && i + 1 < argc) {
+            category = argv[++i];
         }
-        case 2: {
-            int memberID;
-            printHeader("MEMBER PORTAL");
-            printf("Enter Member ID: ");
-            scanf("%d", &memberID);
-            
-            int found = -1;
-            for (int i = 0; i < memberCount; i++) {
-                if (members[i].memberID == memberID && members[i].isActive) {
-                    found = i;
-                    break;
-                }
-            }
-            
-            if (found != -1) {
-                printf("\n✓ Welcome, %s!\n", members[found].name);
-                pauseScreen();
-                
-                while (1) {
-                    printHeader("MEMBER DASHBOARD");
-                    printf("Member: %s (ID: %d)\n\n", members[found].name, memberID);
-                    
-                    printf("1. View My Issued Books\n");
-                    printf("2. View Transaction History\n");
-                    printf("3. Search Books\n");
-                    printf("4. Logout\n");
-                    printf("\nChoice: ");
-                    
-                    int memberChoice;
-                    scanf("%d", &memberChoice);
-                    
-                    switch (memberChoice) {
-                        case 1: {
-                            printHeader("MY ISSUED BOOKS");
-                            
-                            printf("%-30s %-12s %-12s %-8s\n",
-                                   "Book Title", "Issue Date", "Due Date", "Status");
-                            printf("────────────────────────────────────────────────────────────────\n");
-                            
-                            int count = 0;
-                            time_t now = time(NULL);
-                            
-                            for (int i = 0; i < transactionCount; i++) {
-                                if (transactions[i].memberID == memberID && 
-                                    !transactions[i].isReturned) {
-                                    
-                                    char bookTitle[MAX_STRING] = "Unknown";
-                                    for (int j = 0; j < bookCount; j++) {
-                                        if (books[j].bookID == transactions[i].bookID) {
-                                            strcpy(bookTitle, books[j].title);
-                                            break;
-                                        }
-                                    }
-                                    
-                                    char issueStr[12], dueStr[12];
-                                    strftime(issueStr, 12, "%Y-%m-%d", 
-                                            localtime(&transactions[i].issueDate));
-                                    strftime(dueStr, 12, "%Y-%m-%d", 
-                                            localtime(&transactions[i].dueDate));
-                                    
-                                    printf("%-30s %-12s %-12s ", bookTitle, issueStr, dueStr);
-                                    
-                                    if (now > transactions[i].dueDate) {
-                                        int daysOverdue = getDaysDifference(
-                                            transactions[i].dueDate, now);
-                                        printf("⚠ OVERDUE (%d days)", daysOverdue);
-                                    } else {
-                                        printf("✓ Active");
-                                    }
-                                    
-                                    printf("\n");
-                                    count++;
-                                }
-                            }
-                            
-                            if (count == 0) {
-                                printf("No books currently issued.\n");
-                            }
-                            
-                            pauseScreen();
-                            break;
-                        }
-                        case 2:
-                            viewMemberHistory(memberID);
-                            break;
-                        case 3:
-                            searchBook();
-                            break;
-                        case 4:
-                            printf("\n✓ Logged out!\n");
-                            pauseScreen();
-                            goto member_exit;
-                        default:
-                            printf("\n✗ Invalid choice!\n");
-                            pauseScreen();
-                    }
-                }
-                member_exit:;
+    }
+    
+    int status = 0;
+    char nextCursor[CURSOR_LENGTH] = "";
+    if (strcmp(argv[1], "export") == 0 && mode != RENDER_JSONL) {
+        mode = RENDER_CSV;
+    }
+    renderBegin(stdout, mode);
+    
+    if (strcmp(argv[1], "books") == 0) {
+        renderBooks(parseBookOrder(order), after, limit, nextCursor);
+    } else if (strcmp(argv[1], "members") == 0) {
+        renderMembers(parseMemberOrder(order), after, limit, nextCursor);
+    } else if (strcmp(argv[1], "issued") == 0) {
+        renderIssuedBooks(libraryNow());
+    } else if (strcmp(argv[1], "history") == 0 && argc > 2) {
+        renderMemberHistory(atoi(argv[2]));
+    } else if (strcmp(argv[1], "query") == 0 && argc > 2) {
+        status = renderQuery(argv[2]) < 0;
+    } else if (strcmp(argv[1], "asof") == 0 && argc > 2 && parseDate(argv[2]) != (time_t)-1) {
+        time_t day = parseDate(argv[2]);
+        time_t end = until != NULL ? parseDate(until) : day;
+        if (end == (time_t)-1 || end < day) {
+            fprintf(stderr, "Invalid --to date: %s\n", until);
+            status = 1;
+        } else {
+            renderLoansDuring(day - SECONDS_PER_DAY + 1, end + 1, bookFilter, memberFilter);
+        }
+    } else if (strcmp(argv[1], "circulation") == 0 && argc > 2 && parsePeriod(argv[2]) >= 0) {
+        int period = parsePeriod(argv[2]);
+        int slot = category != NULL ? circulationCategory(category, 0) : -1;
+        time_t end = until != NULL ? parseDate(until) : libraryNow();
+        if (category != NULL && slot == -1) {
+            fprintf(stderr, "Category %s not found\n", category);
+            status = 1;
+        } else if (end == (time_t)-1) {
+            fprintf(stderr, "Invalid date %s\n", until);
+            status = 1;
+        } else {
+            renderCirculation(period, limit > 0 ? limit : periodDefaultCount[period],
+                              circulationDay(end), slot);
+        }
+    } else if (strcmp(argv[1], "simulate") == 0) {
+        SimulationConfig config = {365, 100, 200, 0.03f, 7.0f, 0.15f, 5.0f, 1};
+        for (int i = 2; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "--days") == 0) config.days = atoi(argv[i + 1]);
+            if (strcmp(argv[i], "--members") == 0) config.members = atoi(argv[i + 1]);
+            if (strcmp(argv[i], "--titles") == 0) config.titles = atoi(argv[i + 1]);
+            if (strcmp(argv[i], "--rate") == 0) config.arrivalRate = (float)atof(argv[i + 1]);
+            if (strcmp(argv[i], "--keep") == 0) config.keepDays = (float)atof(argv[i + 1]);
+            if (strcmp(argv[i], "--late") == 0) config.lateShare = (float)atof(argv[i + 1]);
+            if (strcmp(argv[i], "--late-days") == 0) config.lateDays = (float)atof(argv[i + 1]);
+            if (strcmp(argv[i], "--seed") == 0) config.seed = (unsigned int)atoi(argv[i + 1]);
+        }
+        if (config.members < 1 || config.members > MAX_MEMBERS ||
+            config.titles < 1 || config.titles > MAX_BOOKS || config.days < 1) {
+            fprintf(stderr, "Members must be 1-%d, titles 1-%d and days at least 1\n",
+                    MAX_MEMBERS, MAX_BOOKS);
+            status = 1;
+        } else if (sharedTables != NULL || !renderSimulation(&config)) {
+            status = 1;
+        }
+    } else if (strcmp(argv[1], "recommend") == 0 && argc > 2) {
+        int slot = findBookSlot(atoi(argv[2]));
+        if (slot != -1 && books[slot].isActive) {
+            renderRecommendations(slot, -1, limit > 0 ? limit : NEIGHBOUR_SLOTS);
+        } else {
+            fprintf(stderr, "Book %s not found\n", argv[2]);
+            status = 1;
+        }
+    } else if (strcmp(argv[1], "reminders") == 0) {
+        time_t end = until != NULL ? parseDate(until) : libraryNow();
+        if (end == (time_t)-1) {
+            fprintf(stderr, "Invalid date %s\n", until);
+            status = 1;
+        } else {
+            sharedBegin();
+            int sent = sendReminders(end);
+            sharedEnd();
+            if (sent < 0) {
+                fprintf(stderr, "Could not open %s\n", dataPath(OUTBOX_FILE));
+                status = 1;
             } else {
-                printf("\n✗ Member ID not found!\n");
-                pauseScreen();
+                renderf("Wrote %d notice(s) to %s\n", sent, dataPath(OUTBOX_FILE));
             }
-            break;
         }
-        case 3:
-            return 3;
-        default:
-            printf("\n✗ Invalid choice!\n");
-            pauseScreen();
+    } else if (strcmp(argv[1], "policy") == 0) {
+        renderPolicy();
+    } else if (strcmp(argv[1], "fsck") == 0) {
+        int repair = argc > 2 && strcmp(argv[2], "--repair") == 0;
+        sharedBegin();
+        if (!renderFsck(repair)) status = 1;
+        sharedEnd();
+    } else if (strcmp(argv[1], "compact") == 0) {
+        sharedBegin();
+        int reclaimed = compactTables();
+        sharedEnd();
+        renderf("Reclaimed %d deleted record(s); %d books, %d members remain\n",
+                reclaimed, bookCount, memberCount);
+    } else if (strcmp(argv[1], "report") == 0) {
+        renderSnapshotReport(libraryNow());
+    } else if (strcmp(argv[1], "export") == 0 && argc > 2 && parseExportTable(argv[2]) >= 0) {
+        renderExport(parseExportTable(argv[2]), libraryNow());
+    } else if (strcmp(argv[1], "events") == 0) {
+        renderEvents(from, follow);
+    } else if (strcmp(argv[1], "branches") == 0) {
+        renderBranches();
+    } else if (strcmp(argv[1], "catalog") == 0 && argc > 2) {
+        renderCatalog(argv[2]);
+    } else if (strcmp(argv[1], "search") == 0 && argc > 2) {
+        renderSearch(argv[2], limit);
+    } else if (strcmp(argv[1], "top") == 0 && argc > 2) {
+        int metric = strcmp(argv[2], "members") == 0 ? METRIC_MEMBERS
+                   : strcmp(argv[2], "authors") == 0 ? METRIC_AUTHORS : METRIC_TITLES;
+        int days = 0;
+        for (int i = 3; i + 1 < argc; i++) {
+            if (strcmp(argv[i], "--days") == 0) days = atoi(argv[i + 1]);
+        }
+        renderTopN(metric, days, limit > 0 ? limit : TOP_N);
+    } else {
+        fprintf(stderr, "Usage: %s [--branch NAME] <command> [--tsv]\n", argv[0]);
+        fprintf(stderr, "Commands:\n");
+        fprintf(stderr, "  books [--order id|title|author|availability] [--after CURSOR] [--limit N]\n");
+        fprintf(stderr, "                        List active books, one page at a time\n");
+        fprintf(stderr, "  members [--order id|name] [--after CURSOR] [--limit N]\n");
+        fprintf(stderr, "                        List active members, one page at a time\n");
+        fprintf(stderr, "  issued                List currently issued books\n");
+        fprintf(stderr, "  history <memberID>    Show a member's transactions\n");
+        fprintf(stderr, "  query \"<expr>\"        Filter books, e.g. \"category = Fiction AND available > 0\"\n");
+        fprintf(stderr, "  search \"<words>\" [--limit N]\n");
+        fprintf(stderr, "                        Rank books by relevance to keywords (BM25)\n");
+        fprintf(stderr, "  asof <YYYY-MM-DD> [--to YYYY-MM-DD] [--book ID] [--member ID]\n");
+        fprintf(stderr, "                        Loans open on a date or during a period\n");
+        fprintf(stderr, "  circulation <daily|weekly|monthly> [--limit N] [--to YYYY-MM-DD] [--category NAME]\n");
+        fprintf(stderr, "                        Issues, returns, overdue returns and fines per period\n");
+        fprintf(stderr, "  recommend <bookID>    Books most often borrowed together with it\n");
+        fprintf(stderr, "  simulate [--days N] [--members N] [--titles N] [--rate R] [--keep D]\n");
+        fprintf(stderr, "           [--late P] [--late-days D] [--seed S]\n");
+        fprintf(stderr, "                        Run a synthetic population under a virtual clock in simulation/\n");
+        fprintf(stderr, "  reminders [--to YYYY-MM-DD]\n");
+        fprintf(stderr, "                        Append due-tomorrow and overdue notices to outbox.txt\n");
+        fprintf(stderr, "  policy                Loan limits, periods and fines per member tier and category\n");
+        fprintf(stderr, "  compact               Reclaim deleted books and members\n");
+        fprintf(stderr, "  fsck [--repair]       Verify file checksums and rebuild counters from the loan log\n");
+        fprintf(stderr, "  report                Full report: statistics, liabilities, loans, history\n");
+        fprintf(stderr, "  export <books|members|transactions|loans> [--jsonl]\n");
+        fprintf(stderr, "                        Export a table as CSV (or JSON Lines)\n");
+        fprintf(stderr, "  events [--from SEQ] [--follow]\n");
+        fprintf(stderr, "                        Stream add/update/delete/issue/return events\n");
+        fprintf(stderr, "  branches              List branches and their ID ranges\n");
+        fprintf(stderr, "  catalog \"<text>\"      Search titles, authors and ISBNs in every branch\n");
+        fprintf(stderr, "  top <titles|members|authors> [--days N] [--limit N]\n");
+        fprintf(stderr, "                        Most borrowed titles, active members, overdue authors\n");
+        status = 1;
     }
     
-    return 0;
+    renderEnd();
+    
+    if (nextCursor[0] != '\0') {
+        fprintf(stderr, "next cursor: %s\n", nextCursor);
+    }
+    return status;
 }